@@ -0,0 +1,150 @@
+
+#include "HeatAccuracy.h"
+
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instruction.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace llvm {
+
+/// Ranks from 1 to N, where tied values get the average of their ranks.
+static std::vector<double> getRanks(ArrayRef<uint64_t> Values){
+  std::vector<unsigned> Order(Values.size());
+  for (unsigned i = 0; i<Values.size(); i++)
+    Order[i] = i;
+  std::sort(Order.begin(), Order.end(), [&Values](unsigned A, unsigned B) {
+    return Values[A]<Values[B];
+  });
+
+  std::vector<double> Ranks(Values.size());
+  for (unsigned i = 0; i<Order.size(); ) {
+    unsigned j = i;
+    while (j<Order.size() && Values[Order[j]]==Values[Order[i]])
+      j++;
+    double Rank = (i+1+j)/2.0;
+    for (unsigned k = i; k<j; k++)
+      Ranks[Order[k]] = Rank;
+    i = j;
+  }
+  return Ranks;
+}
+
+double getRankCorrelation(ArrayRef<uint64_t> A, ArrayRef<uint64_t> B){
+  std::vector<double> RA = getRanks(A);
+  std::vector<double> RB = getRanks(B);
+  unsigned N = RA.size();
+  double Mean = (N+1)/2.0;
+  double Cov = 0, VarA = 0, VarB = 0;
+  for (unsigned i = 0; i<N; i++) {
+    Cov += (RA[i]-Mean)*(RB[i]-Mean);
+    VarA += (RA[i]-Mean)*(RA[i]-Mean);
+    VarB += (RB[i]-Mean)*(RB[i]-Mean);
+  }
+  if (VarA==0 || VarB==0)
+    return (VarA==0 && VarB==0)?1.0:0.0;
+  return Cov/std::sqrt(VarA*VarB);
+}
+
+std::unique_ptr<Module> cloneWithoutProfile(const Module &M){
+  std::unique_ptr<Module> Clone = CloneModule(&M);
+  for (Function &F : *Clone) {
+    // The entry count is also kept as profile metadata of the function.
+    F.setMetadata(LLVMContext::MD_prof, nullptr);
+    for (BasicBlock &BB : F)
+      for (Instruction &I : BB)
+        I.setMetadata(LLVMContext::MD_prof, nullptr);
+  }
+  return Clone;
+}
+
+/// Fraction of the \p K largest values of \p A that are also among the \p K
+/// largest values of \p B.
+static double getTopOverlap(ArrayRef<uint64_t> A, ArrayRef<uint64_t> B,
+                            unsigned K){
+  K = std::min<unsigned>(K,A.size());
+  if (K==0)
+    return 1.0;
+  auto getTop = [K](ArrayRef<uint64_t> Values) {
+    std::vector<unsigned> Order(Values.size());
+    for (unsigned i = 0; i<Values.size(); i++)
+      Order[i] = i;
+    std::partial_sort(Order.begin(), Order.begin()+K, Order.end(),
+                      [&Values](unsigned X, unsigned Y) {
+                        return Values[X]>Values[Y];
+                      });
+    Order.resize(K);
+    std::sort(Order.begin(), Order.end());
+    return Order;
+  };
+  std::vector<unsigned> TopA = getTop(A);
+  std::vector<unsigned> TopB = getTop(B);
+  std::vector<unsigned> Common;
+  std::set_intersection(TopA.begin(), TopA.end(), TopB.begin(), TopB.end(),
+                        std::back_inserter(Common));
+  return double(Common.size())/K;
+}
+
+HeatAccuracy HeatAccuracy::compare(const HeatProfile &Profiled,
+                                   const HeatProfile &Estimated,
+                                   unsigned TopK){
+  assert(Profiled.getNumBlocks()==Estimated.getNumBlocks() &&
+         "profiles of different modules");
+  HeatAccuracy Acc;
+  Acc.TopK = TopK;
+  Acc.RankCorrelation = getRankCorrelation(Profiled.blockFreqs(),
+                                           Estimated.blockFreqs());
+  Acc.TopBlockOverlap = getTopOverlap(Profiled.blockFreqs(),
+                                      Estimated.blockFreqs(), TopK);
+  Acc.TopFunctionOverlap = getTopOverlap(Profiled.functionMaxFreqs(),
+                                         Estimated.functionMaxFreqs(), TopK);
+
+  for (unsigned FI = 0; FI<Profiled.getNumFunctions(); FI++) {
+    ArrayRef<uint64_t> P = Profiled.blockFreqs(FI);
+    ArrayRef<uint64_t> E = Estimated.blockFreqs(FI);
+    HeatFunctionAccuracy FAcc;
+    FAcc.Function = FI;
+    FAcc.RankCorrelation = getRankCorrelation(P,E);
+    double Error = 0;
+    for (unsigned i = 0; i<P.size(); i++)
+      Error += std::fabs(Profiled.getHeat(P[i])-Estimated.getHeat(E[i]));
+    FAcc.HeatError = P.empty()?0:Error/P.size();
+    Acc.Functions.push_back(FAcc);
+  }
+  std::stable_sort(Acc.Functions.begin(), Acc.Functions.end(),
+                   [](const HeatFunctionAccuracy &A,
+                      const HeatFunctionAccuracy &B) {
+                     return A.HeatError>B.HeatError;
+                   });
+  return Acc;
+}
+
+void HeatAccuracy::print(raw_ostream &OS, const HeatProfile &Profiled,
+                         unsigned NumWorst) const {
+  OS << "heat accuracy of '" << Profiled.getModule().getModuleIdentifier()
+     << "'\n";
+  OS << "functions " << Profiled.getNumFunctions() << ", blocks "
+     << Profiled.getNumBlocks() << "\n";
+  OS << "block rank correlation " << format("%.4f", RankCorrelation) << "\n";
+  OS << "top-" << TopK << " blocks overlap "
+     << format("%.4f", TopBlockOverlap) << "\n";
+  OS << "top-" << TopK << " functions overlap "
+     << format("%.4f", TopFunctionOverlap) << "\n";
+
+  OS << "# heat-error rank-correlation max-freq function\n";
+  for (unsigned i = 0; i<Functions.size() && i<NumWorst; i++) {
+    const HeatFunctionAccuracy &FAcc = Functions[i];
+    OS << format("%.4f", FAcc.HeatError) << " "
+       << format("%.4f", FAcc.RankCorrelation) << " "
+       << Profiled.getFunctionMaxFreq(FAcc.Function) << " "
+       << Profiled.getFunction(FAcc.Function)->getName() << "\n";
+  }
+}
+
+}
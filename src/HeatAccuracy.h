@@ -0,0 +1,75 @@
+//===-- HeatAccuracy.h - Accuracy of the heuristic heat ---------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the comparison of the heuristic heat, estimated by BFI
+// when a module has no profile, against the heat given by the profile of the
+// same module. It tells how much the heat maps of modules that cannot be
+// profiled can be trusted.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATACCURACY_H
+#define LLVM_ANALYSIS_HEATACCURACY_H
+
+#include "HeatProfile.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <memory>
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+/// Spearman's rank correlation of \p A and \p B, with tied values ranked by
+/// their average rank. If one of them is constant, returns 1 if both are
+/// and 0 otherwise.
+double getRankCorrelation(ArrayRef<uint64_t> A, ArrayRef<uint64_t> B);
+
+/// Returns a copy of \p M without any profile metadata, whose HeatProfile
+/// has the heuristic frequencies.
+std::unique_ptr<Module> cloneWithoutProfile(const Module &M);
+
+struct HeatFunctionAccuracy {
+  /// Index of the function in both profiles.
+  unsigned Function;
+  /// Rank correlation of the block frequencies of the function.
+  double RankCorrelation;
+  /// Mean absolute difference of the heat of the blocks of the function.
+  double HeatError;
+};
+
+struct HeatAccuracy {
+  /// Rank correlation of the frequencies of all blocks of the module.
+  double RankCorrelation = 0;
+  /// Fraction of the K hottest blocks and functions of the profile that are
+  /// also among the K hottest ones of the estimation.
+  unsigned TopK = 0;
+  double TopBlockOverlap = 0;
+  double TopFunctionOverlap = 0;
+  /// Per function, sorted by decreasing heat error.
+  std::vector<HeatFunctionAccuracy> Functions;
+
+  /// Compares the heuristic frequencies of \p Estimated against the profile
+  /// counts of \p Profiled. Both profiles must be of the same module, or of
+  /// a copy, e.g. from cloneWithoutProfile.
+  static HeatAccuracy compare(const HeatProfile &Profiled,
+                              const HeatProfile &Estimated, unsigned TopK);
+
+  /// Prints the report, with the \p NumWorst worst estimated functions.
+  void print(raw_ostream &OS, const HeatProfile &Profiled,
+             unsigned NumWorst) const;
+};
+
+}
+
+#endif
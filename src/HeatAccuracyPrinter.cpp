@@ -0,0 +1,76 @@
+//===-- HeatAccuracyPrinter.cpp - Heat accuracy printer ---------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-accuracy' analysis pass. The profile is removed
+// from a copy of the module, whose block frequencies are then estimated by
+// BFI as for modules without profile, and compared against the profile.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeatAccuracyPrinter.h"
+#include "HeatAccuracy.h"
+#include "HeatBFIProvider.h"
+#include "HeatMemoryBudget.h"
+#include "HeatPrinterOptions.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+
+static cl::opt<unsigned>
+AccuracyTopK("heat-accuracy-top", cl::init(100), cl::Hidden,
+             cl::desc("Number of hottest blocks and functions compared"));
+
+static cl::opt<unsigned>
+AccuracyWorst("heat-accuracy-worst", cl::init(20), cl::Hidden,
+              cl::desc("Number of worst estimated functions reported"));
+
+namespace {
+
+bool HeatAccuracyPrinterPass::runOnModule(Module &M) {
+  HeatLog Log;
+  HeatProfile &Profiled = getHeatProfile(M,getHeatProfileOptions());
+  if (!Profiled.hasProfiling()) {
+    Log << "heat-accuracy: module '" << M.getModuleIdentifier()
+        << "' has no profile\n";
+    return false;
+  }
+
+  std::unique_ptr<Module> Clone = cloneWithoutProfile(M);
+  HeatBFIProvider BFIs;
+  HeatProfile Estimated(*Clone,BFIs);
+  HeatMemoryBudget &Budget = HeatMemoryBudget::instance();
+  Budget.acquire(Estimated.getMemorySize());
+  HeatAccuracy Acc = HeatAccuracy::compare(Profiled,Estimated,AccuracyTopK);
+  Budget.release(Estimated.getMemorySize());
+
+  std::string Filename = getHeatOutputFilename(M.getModuleIdentifier(),
+                                               getHeatOutputTag(),
+                                               ".heataccuracy.txt");
+  writeHeatReport(Filename,[&](raw_ostream &OS) {
+    Acc.print(OS,Profiled,AccuracyWorst);
+  });
+  return false;
+}
+
+}
+
+char HeatAccuracyPrinterPass::ID = 0;
+static RegisterPass<HeatAccuracyPrinterPass> X("heat-accuracy",
+          "Compare the heuristic heat of the module against its profile.",
+          false, false);
@@ -0,0 +1,38 @@
+//===-- HeatAccuracyPrinter.h - Heuristic heat accuracy printer -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-accuracy' analysis pass, which compares the
+// heuristic heat of a profiled module against its profile and emits the
+// <module>.heataccuracy.txt report.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATACCURACYPRINTER_H
+#define LLVM_ANALYSIS_HEATACCURACYPRINTER_H
+
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace {
+
+class HeatAccuracyPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatAccuracyPrinterPass() : HeatReportPass(ID) {}
+
+  bool runOnModule(Module &M) override;
+};
+
+}
+
+#endif
@@ -0,0 +1,111 @@
+
+#include "HeatAnnotatedIR.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/AssemblyAnnotationWriter.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instruction.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FormattedStream.h"
+#include "llvm/Support/Format.h"
+
+#include <cstdlib>
+#include <string>
+
+namespace llvm {
+
+namespace {
+
+class HeatAnnotationWriter : public AssemblyAnnotationWriter {
+  const HeatProfile &HP;
+  const HeatIROptions &Opts;
+
+  uint64_t getMaxFreq(const Function *F) const {
+    return Opts.PerFunction?HP.getFunctionMaxFreq(F):HP.getMaxFreq();
+  }
+
+  void printHeat(formatted_raw_ostream &OS, uint64_t Freq,
+                 uint64_t MaxFreq) const {
+    double Percent = MaxFreq?100.0*Freq/MaxFreq:0.0;
+    OS << Freq << " (" << format("%.2f", Percent) << "%), bucket "
+       << getHeatBucket(Freq,MaxFreq);
+  }
+
+  /// Sets the foreground color to the heat color of \p Freq.
+  void startColor(formatted_raw_ostream &OS, uint64_t Freq,
+                  uint64_t MaxFreq) const {
+    std::string Color = getHeatColor(Freq,MaxFreq);
+    unsigned long RGB = std::strtoul(Color.c_str()+1, nullptr, 16);
+    OS << "\x1b[38;2;" << ((RGB>>16)&0xff) << ";" << ((RGB>>8)&0xff) << ";"
+       << (RGB&0xff) << "m";
+  }
+
+  void endColor(formatted_raw_ostream &OS) const {
+    OS << "\x1b[0m";
+  }
+
+public:
+  HeatAnnotationWriter(const HeatProfile &HP, const HeatIROptions &Opts)
+      : HP(HP), Opts(Opts) {}
+
+  void emitFunctionAnnot(const Function *F,
+                         formatted_raw_ostream &OS) override {
+    int FI = HP.getFunctionIndex(F);
+    if (FI<0)
+      return;
+    uint64_t MaxFreq = Opts.PerFunction?HP.getFunctionMaxFreq(FI):
+                                         HP.getMaxFreq();
+    if (Opts.Color)
+      startColor(OS,HP.getFunctionMaxFreq(FI),HP.getMaxFreq());
+    OS << "; heat: max freq ";
+    printHeat(OS,HP.getFunctionMaxFreq(FI),HP.getMaxFreq());
+    if (uint64_t EntryCount = HP.getFunctionEntryCount(FI))
+      OS << ", entry count " << EntryCount;
+    if (Opts.PerFunction)
+      OS << ", scaled by " << MaxFreq;
+    if (Opts.Color)
+      endColor(OS);
+    OS << "\n";
+  }
+
+  void emitBasicBlockStartAnnot(const BasicBlock *BB,
+                                formatted_raw_ostream &OS) override {
+    int BI = HP.getBlockIndex(BB);
+    if (BI<0)
+      return;
+    uint64_t Freq = HP.getBlockFreq(BI);
+    uint64_t MaxFreq = getMaxFreq(BB->getParent());
+    if (Opts.Color)
+      startColor(OS,Freq,MaxFreq);
+    OS << "  ; heat: freq ";
+    printHeat(OS,Freq,MaxFreq);
+    if (Opts.Color)
+      endColor(OS);
+    OS << "\n";
+  }
+
+  void emitInstructionAnnot(const Instruction *I,
+                            formatted_raw_ostream &OS) override {
+    if (!Opts.Color)
+      return;
+    int BI = HP.getBlockIndex(I->getParent());
+    if (BI>=0)
+      startColor(OS,HP.getBlockFreq(BI),getMaxFreq(I->getFunction()));
+  }
+
+  void printInfoComment(const Value &V, formatted_raw_ostream &OS) override {
+    if (Opts.Color && isa<Instruction>(V))
+      endColor(OS);
+  }
+};
+
+}
+
+void writeHeatAnnotatedIR(raw_ostream &OS, const HeatProfile &HP,
+                          const HeatIROptions &Opts){
+  HeatAnnotationWriter Writer(HP,Opts);
+  HP.getModule().print(OS, &Writer);
+}
+
+}
@@ -0,0 +1,46 @@
+//===-- HeatAnnotatedIR.h - Heat annotated textual IR -----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the printing of a module as textual IR annotated with
+// heat comments on its functions and blocks, which can be searched with the
+// usual text tools instead of rendering the heat CFGs. The module is printed
+// in a single pass through an AssemblyAnnotationWriter, so values are
+// numbered only once for the whole module.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATANNOTATEDIR_H
+#define LLVM_ANALYSIS_HEATANNOTATEDIR_H
+
+#include "HeatProfile.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+
+namespace llvm {
+
+struct HeatIROptions {
+  /// Scale the heat by the maximum frequency of the function instead of the
+  /// maximum frequency of the module.
+  bool PerFunction = false;
+  /// Color the instructions with the heat of their block, with ANSI escape
+  /// sequences for terminals with 24-bit colors.
+  bool Color = false;
+};
+
+/// Prints the module of \p HP with a heat comment for each function and
+/// block, giving its frequency, its percentage of the maximum frequency and
+/// its bucket in the heat palette.
+void writeHeatAnnotatedIR(raw_ostream &OS, const HeatProfile &HP,
+                          const HeatIROptions &Opts);
+
+}
+
+#endif
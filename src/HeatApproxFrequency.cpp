@@ -0,0 +1,126 @@
+
+#include "HeatApproxFrequency.h"
+
+#include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/Instructions.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace llvm {
+
+/// Largest trip count of a loop, used when its back edges are taken with a
+/// probability close to 1, as BFI does for infinite loops.
+static const double MaxLoopScale = 4096.0;
+
+/// Largest integer frequency, as in BFI.
+static const double MaxFreq = double(UINT64_C(1) << 60);
+
+static double toDouble(BranchProbability P){
+  return double(P.getNumerator())/double(P.getDenominator());
+}
+
+HeatApproxFrequency::HeatApproxFrequency(Function &F){
+  DT.recalculate(F);
+  LI.analyze(DT);
+  BPI.calculate(F,LI);
+
+  EntryCount = 0;
+  Optional< uint64_t > Count = F.getEntryCount();
+  if (Count.hasValue())
+    EntryCount = Count.getValue();
+
+  std::vector<const BasicBlock *> Order;
+  DenseMap<const BasicBlock *, unsigned> Position;
+  ReversePostOrderTraversal<Function *> RPOT(&F);
+  for (BasicBlock *BB : RPOT) {
+    Position[BB] = Order.size();
+    Order.push_back(BB);
+  }
+
+  // Each block distributes its mass over its forward edges only, in
+  // proportion to their probabilities, so that the mass leaving a loop is
+  // the mass that entered it. Unreachable blocks keep a null mass.
+  std::vector<double> Mass(Order.size(),0.0);
+  if (!Mass.empty())
+    Mass[0] = 1.0;
+  for (unsigned i = 0; i<Order.size(); i++) {
+    const TerminatorInst *TI = Order[i]->getTerminator();
+    unsigned NumSuccs = TI->getNumSuccessors();
+    double Forward = 0;
+    for (unsigned S = 0; S<NumSuccs; S++)
+      if (Position.lookup(TI->getSuccessor(S))>i)
+        Forward += toDouble(BPI.getEdgeProbability(Order[i],S));
+    if (Forward<=0)
+      continue;
+    for (unsigned S = 0; S<NumSuccs; S++) {
+      const BasicBlock *Succ = TI->getSuccessor(S);
+      unsigned SP = Position.lookup(Succ);
+      if (SP>i)
+        Mass[SP] += Mass[i]*toDouble(BPI.getEdgeProbability(Order[i],S))/
+                    Forward;
+    }
+  }
+
+  // The masses are relative to the header within each loop, and are then
+  // scaled by the trip counts of the loops.
+  for (unsigned i = 0; i<Order.size(); i++)
+    RelFreq[Order[i]] = Mass[i];
+  for (const Loop *L : LI)
+    computeLoopScales(L,1.0);
+
+  double MinRel = 0, MaxRel = 0;
+  for (auto &Entry : RelFreq) {
+    if (const Loop *L = LI.getLoopFor(Entry.first))
+      Entry.second *= LoopScale.lookup(L);
+    double Rel = Entry.second;
+    if (Rel>0 && (MinRel==0 || Rel<MinRel))
+      MinRel = Rel;
+    MaxRel = std::max(MaxRel,Rel);
+  }
+  FreqScale = (MinRel>0)?8.0/MinRel:1.0;
+  if (MaxRel*FreqScale>MaxFreq)
+    FreqScale = MaxFreq/MaxRel;
+}
+
+/// The trip count of a loop is 1/(1-P), where P is the probability of
+/// going back to the header from it, i.e. the mass of its back edges
+/// relative to the mass of the header.
+void HeatApproxFrequency::computeLoopScales(const Loop *L,
+                                            double ParentScale){
+  const BasicBlock *Header = L->getHeader();
+  double HeaderMass = RelFreq.lookup(Header);
+  double BackMass = 0;
+  for (const BasicBlock *Pred : predecessors(Header)) {
+    if (!L->contains(Pred))
+      continue;
+    const TerminatorInst *TI = Pred->getTerminator();
+    for (unsigned S = 0; S<TI->getNumSuccessors(); S++)
+      if (TI->getSuccessor(S)==Header)
+        BackMass += RelFreq.lookup(Pred)*
+                    toDouble(BPI.getEdgeProbability(Pred,S));
+  }
+
+  double Scale = 1.0;
+  if (HeaderMass>0) {
+    double Back = std::min(BackMass/HeaderMass,1.0-1.0/MaxLoopScale);
+    Scale = 1.0/(1.0-Back);
+  }
+  Scale *= ParentScale;
+  LoopScale[L] = Scale;
+  for (const Loop *SubLoop : *L)
+    computeLoopScales(SubLoop,Scale);
+}
+
+uint64_t HeatApproxFrequency::getBlockFreq(const BasicBlock *BB) const {
+  return uint64_t(std::round(RelFreq.lookup(BB)*FreqScale));
+}
+
+uint64_t
+HeatApproxFrequency::getBlockProfileCount(const BasicBlock *BB) const {
+  double Count = RelFreq.lookup(BB)*double(EntryCount);
+  return uint64_t(std::round(std::min(Count,MaxFreq)));
+}
+
+}
@@ -0,0 +1,70 @@
+//===-- HeatApproxFrequency.h - Linear time block frequencies ---*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines an approximate block frequency estimator, used instead of
+// BFI for huge functions, e.g. generated ones with hundreds of thousands of
+// blocks, where BFI is the slowest step of the heat passes.
+//
+// The frequencies are propagated once over the CFG in reverse post-order,
+// following the branch probabilities of the forward edges only, and then
+// scaled by the trip count of each enclosing loop, estimated from the
+// probability of its back edges. The retreating edges of irreducible loops
+// are dropped rather than iterated, so the estimation is linear in the size
+// of the function.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATAPPROXFREQUENCY_H
+#define LLVM_ANALYSIS_HEATAPPROXFREQUENCY_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Function.h"
+
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+class HeatApproxFrequency {
+public:
+  explicit HeatApproxFrequency(Function &F);
+
+  /// Estimated frequency of \p BB, scaled as BFI does, so that the smallest
+  /// non-zero frequency of the function is 8.
+  uint64_t getBlockFreq(const BasicBlock *BB) const;
+
+  /// Profile count of \p BB from the entry count of the function, or 0 if
+  /// the function has none.
+  uint64_t getBlockProfileCount(const BasicBlock *BB) const;
+
+  const BranchProbabilityInfo &getBPI() const { return BPI; }
+
+private:
+  void computeLoopScales(const Loop *L, double ParentScale);
+
+  DominatorTree DT;
+  LoopInfo LI;
+  BranchProbabilityInfo BPI;
+  uint64_t EntryCount;
+  /// Frequency of each reachable block relative to the entry, and the factor
+  /// that scales them to integers.
+  DenseMap<const BasicBlock *, double> RelFreq;
+  double FreqScale;
+  /// Product of the trip counts of a loop and of its parents.
+  DenseMap<const Loop *, double> LoopScale;
+};
+
+}
+
+#endif
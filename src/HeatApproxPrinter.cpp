@@ -0,0 +1,111 @@
+//===-- HeatApproxPrinter.cpp - Approximate frequency deviation -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-approx-deviation' analysis pass. The heat data of
+// the module is computed twice, once with BFI and once with the approximate
+// frequencies of -heat-approx-min-blocks (of all the functions if it is not
+// given), and the report tells how much they differ and how long each took.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeatApproxPrinter.h"
+#include "HeatAccuracy.h"
+#include "HeatBFIProvider.h"
+#include "HeatMemoryBudget.h"
+#include "HeatPrinterOptions.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <string>
+
+using namespace llvm;
+
+
+static cl::opt<unsigned>
+ApproxTopK("heat-approx-top", cl::init(100), cl::Hidden,
+           cl::desc("Number of hottest blocks and functions compared"));
+
+static cl::opt<unsigned>
+ApproxWorst("heat-approx-worst", cl::init(20), cl::Hidden,
+            cl::desc("Number of most deviating functions reported"));
+
+typedef std::chrono::steady_clock Clock;
+
+static double getMilliseconds(Clock::time_point Start, Clock::time_point End){
+  return std::chrono::duration<double, std::milli>(End-Start).count();
+}
+
+namespace {
+
+void HeatApproxPrinterPass::getAnalysisUsage(AnalysisUsage &AU) const {
+  ModulePass::getAnalysisUsage(AU);
+  AU.setPreservesAll();
+}
+
+bool HeatApproxPrinterPass::runOnModule(Module &M) {
+  HeatProfileOptions ApproxOpts = getHeatProfileOptions();
+  if (!ApproxOpts.ApproxMinBlocks)
+    ApproxOpts.ApproxMinBlocks = 1;
+
+  // Each profile has its own BFIs, so that both times include the analyses
+  // they depend on.
+  Clock::time_point Start = Clock::now();
+  HeatBFIProvider ExactBFIs;
+  HeatProfile Exact(M,ExactBFIs);
+  Clock::time_point Middle = Clock::now();
+  HeatBFIProvider ApproxBFIs;
+  HeatProfile Approx(M,ApproxBFIs,ApproxOpts);
+  Clock::time_point End = Clock::now();
+  HeatMemoryBudget &Budget = HeatMemoryBudget::instance();
+  Budget.acquire(Exact.getMemorySize()+Approx.getMemorySize());
+
+  unsigned NumApprox = 0, NumApproxBlocks = 0;
+  for (unsigned FI = 0; FI<Exact.getNumFunctions(); FI++) {
+    unsigned NumBlocks = Exact.blocks(FI).size();
+    if (NumBlocks>=ApproxOpts.ApproxMinBlocks) {
+      NumApprox++;
+      NumApproxBlocks += NumBlocks;
+    }
+  }
+  HeatAccuracy Acc = HeatAccuracy::compare(Exact,Approx,ApproxTopK);
+  Budget.release(Exact.getMemorySize()+Approx.getMemorySize());
+
+  std::string Filename = getHeatOutputFilename(M.getModuleIdentifier(),
+                                               getHeatOutputTag(),
+                                               ".heatapprox.txt");
+  writeHeatReport(Filename,[&](raw_ostream &OS) {
+    OS << "approximate functions " << NumApprox << " (at least "
+       << ApproxOpts.ApproxMinBlocks << " blocks), blocks "
+       << NumApproxBlocks << "\n";
+    OS << "bfi time " << format("%.1f", getMilliseconds(Start,Middle))
+       << " ms, approximate time "
+       << format("%.1f", getMilliseconds(Middle,End)) << " ms\n";
+    Acc.print(OS,Exact,ApproxWorst);
+  });
+  return false;
+}
+
+bool HeatApproxPrinterPass::doFinalization(Module &M) {
+  HeatMemoryBudget::instance().finalize();
+  return false;
+}
+
+}
+
+char HeatApproxPrinterPass::ID = 0;
+static RegisterPass<HeatApproxPrinterPass> X("heat-approx-deviation",
+          "Compare the approximate block frequencies against those of BFI.",
+          false, false);
@@ -0,0 +1,38 @@
+//===-- HeatApproxPrinter.h - Approximate frequency deviation ---*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-approx-deviation' analysis pass, which compares
+// the approximate block frequencies against those of BFI and emits the
+// <module>.heatapprox.txt report.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATAPPROXPRINTER_H
+#define LLVM_ANALYSIS_HEATAPPROXPRINTER_H
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace {
+
+class HeatApproxPrinterPass : public ModulePass {
+public:
+  static char ID;
+  HeatApproxPrinterPass() : ModulePass(ID) {}
+
+  void getAnalysisUsage(AnalysisUsage &AU) const;
+  bool runOnModule(Module &M) override;
+  bool doFinalization(Module &M) override;
+};
+
+}
+
+#endif
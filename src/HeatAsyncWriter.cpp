@@ -0,0 +1,98 @@
+
+#include "HeatAsyncWriter.h"
+#include "HeatMemoryBudget.h"
+#include "HeatUtils.h"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+
+namespace llvm {
+
+HeatAsyncWriter::HeatAsyncWriter(unsigned Capacity)
+    : Ring(std::max(Capacity,1u)), Head(0), Tail(0), Done(false),
+      ProducerSleeping(false), WriterSleeping(false) {
+  Writer = std::thread([this]() { run(); });
+}
+
+HeatAsyncWriter::~HeatAsyncWriter(){
+  finish();
+}
+
+/// Sleeps until \p Ready holds. The flag is raised before checking \p Ready,
+/// so the other side either sees it and wakes us up, or made \p Ready true
+/// before the check.
+void HeatAsyncWriter::sleepUntil(std::atomic<bool> &Sleeping,
+                                 const std::function<bool()> &Ready){
+  std::unique_lock<std::mutex> Lock(Mutex);
+  Sleeping = true;
+  Wake.wait(Lock, Ready);
+  Sleeping = false;
+}
+
+void HeatAsyncWriter::wakeUp(std::atomic<bool> &Sleeping){
+  if (!Sleeping)
+    return;
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Wake.notify_all();
+}
+
+void HeatAsyncWriter::write(std::string Filename, std::string Contents){
+  size_t T = Tail;
+  HeatMemoryBudget &Budget = HeatMemoryBudget::instance();
+  if (!Budget.tryAcquire(Contents.size())) {
+    sleepUntil(ProducerSleeping, [&]() { return T==Head; });
+    Budget.acquire(Contents.size());
+  } else if (T-Head==Ring.size()) {
+    sleepUntil(ProducerSleeping, [&]() { return T-Head!=Ring.size(); });
+  }
+
+  Buffer &B = Ring[T%Ring.size()];
+  B.Filename = std::move(Filename);
+  B.Contents = std::move(Contents);
+  Tail = T+1;
+  wakeUp(WriterSleeping);
+}
+
+void HeatAsyncWriter::run(){
+  while (true) {
+    size_t H = Head;
+    if (H==Tail) {
+      // Done is raised after the last write, so Tail must be read again.
+      if (Done && H==Tail)
+        return;
+      sleepUntil(WriterSleeping, [&]() { return H!=Tail || Done; });
+      continue;
+    }
+
+    Buffer B = std::move(Ring[H%Ring.size()]);
+    Ring[H%Ring.size()] = Buffer();
+    Head = H+1;
+    wakeUp(ProducerSleeping);
+
+    removeHeatOutputFile(B.Filename);
+    std::error_code EC;
+    raw_fd_ostream File(B.Filename, EC, sys::fs::F_Text);
+    if (!EC) {
+      File << B.Contents;
+      File.close();
+    }
+    if (EC || File.has_error()) {
+      File.clear_error();
+      Failed.push_back(B.Filename);
+    }
+    HeatMemoryBudget::instance().release(B.Contents.size());
+  }
+}
+
+const std::vector<std::string> &HeatAsyncWriter::finish(){
+  if (Writer.joinable()) {
+    Done = true;
+    wakeUp(WriterSleeping);
+    Writer.join();
+  }
+  return Failed;
+}
+
+}
@@ -0,0 +1,79 @@
+//===-- HeatAsyncWriter.h - Asynchronous output of heat files ---*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines an asynchronous writer for the heat output files. The
+// files are formatted into buffers by the printer and passed through a
+// bounded single-producer single-consumer ring to a writer thread, so that
+// formatting the next file overlaps with writing the previous ones.
+//
+// The ring itself is lock-free. A mutex is only taken to sleep when the ring
+// is full or empty, and to wake up the other side from that sleep.
+//
+// The pending buffers are accounted in the memory budget. When a buffer does
+// not fit, the producer waits until the ring is empty before queueing it, so
+// that at most one buffer over the budget is pending.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATASYNCWRITER_H
+#define LLVM_ANALYSIS_HEATASYNCWRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llvm {
+
+class HeatAsyncWriter {
+public:
+  /// Starts the writer thread, with room for \p Capacity pending files.
+  explicit HeatAsyncWriter(unsigned Capacity);
+  ~HeatAsyncWriter();
+
+  /// Queues \p Contents to be written to \p Filename, blocking while the
+  /// queue is full or over the memory budget. Must always be called from the
+  /// same thread.
+  void write(std::string Filename, std::string Contents);
+
+  /// Waits until all the queued files are written and stops the writer
+  /// thread. Returns the files that could not be written.
+  const std::vector<std::string> &finish();
+
+private:
+  struct Buffer {
+    std::string Filename;
+    std::string Contents;
+  };
+
+  void run();
+  void sleepUntil(std::atomic<bool> &Sleeping,
+                  const std::function<bool()> &Ready);
+  void wakeUp(std::atomic<bool> &Sleeping);
+
+  std::vector<Buffer> Ring;
+  /// Head is only advanced by the writer thread, and Tail by the producer.
+  /// Both only grow, the slot of an index is its value modulo the size.
+  std::atomic<size_t> Head;
+  std::atomic<size_t> Tail;
+  std::atomic<bool> Done;
+  std::atomic<bool> ProducerSleeping;
+  std::atomic<bool> WriterSleeping;
+  std::mutex Mutex;
+  std::condition_variable Wake;
+  std::vector<std::string> Failed;
+  std::thread Writer;
+};
+
+}
+
+#endif
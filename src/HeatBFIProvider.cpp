@@ -0,0 +1,48 @@
+
+#include "HeatBFIProvider.h"
+#include "HeatMemoryBudget.h"
+
+#include <algorithm>
+
+namespace llvm {
+
+/// Rough size of the analyses of a function per block, for the dominator
+/// tree, loop info, branch probabilities and block frequencies.
+static const uint64_t AnalysesBytesPerBlock = 256;
+
+BlockFrequencyInfo *HeatBFIProvider::get(Function &F){
+  std::unique_ptr<FunctionAnalyses> &Entry = Analyses[&F];
+  if (Entry)
+    return &Entry->BFI;
+
+  Entry.reset(new FunctionAnalyses());
+  Entry->DT.recalculate(F);
+  Entry->LI.analyze(Entry->DT);
+  Entry->BPI.calculate(F,Entry->LI);
+  Entry->BFI.calculate(F,Entry->BPI,Entry->LI);
+  Entry->Size = F.size()*AnalysesBytesPerBlock;
+  BlockFrequencyInfo *BFI = &Entry->BFI;
+
+  HeatMemoryBudget &Budget = HeatMemoryBudget::instance();
+  Budget.acquire(Entry->Size);
+  Order.push_back(&F);
+  while (Budget.isOverLimit() && Order.size()>1)
+    forget(*Order.front());
+  return BFI;
+}
+
+void HeatBFIProvider::forget(const Function &F){
+  auto It = Analyses.find(&F);
+  if (It==Analyses.end())
+    return;
+  HeatMemoryBudget::instance().release(It->second->Size);
+  Analyses.erase(It);
+  Order.erase(std::find(Order.begin(), Order.end(), &F));
+}
+
+void HeatBFIProvider::clear(){
+  while (!Order.empty())
+    forget(*Order.front());
+}
+
+}
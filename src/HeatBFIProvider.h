@@ -0,0 +1,71 @@
+//===-- HeatBFIProvider.h - Standalone block frequency info -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines HeatBFIProvider, which computes and owns the block
+// frequency info of functions outside of a pass manager, so that a
+// HeatProfile can be built by tools that do not run inside 'opt'.
+//
+// The analyses are kept for reuse and accounted in the memory budget. With a
+// limit, the oldest ones are dropped when the budget is exceeded.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATBFIPROVIDER_H
+#define LLVM_ANALYSIS_HEATBFIPROVIDER_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Function.h"
+
+#include <deque>
+#include <memory>
+
+using namespace llvm;
+
+namespace llvm {
+
+class HeatBFIProvider {
+public:
+  HeatBFIProvider() = default;
+  HeatBFIProvider(const HeatBFIProvider &) = delete;
+  HeatBFIProvider &operator=(const HeatBFIProvider &) = delete;
+  ~HeatBFIProvider() { clear(); }
+
+  /// Returns the block frequency info of \p F, computing it on first use.
+  /// With a memory limit, it is only valid until the next call.
+  BlockFrequencyInfo *get(Function &F);
+
+  BlockFrequencyInfo *operator()(Function &F) { return get(F); }
+
+  /// Drops the analyses of \p F, e.g. after it has been modified.
+  void forget(const Function &F);
+
+  void clear();
+
+private:
+  struct FunctionAnalyses {
+    DominatorTree DT;
+    LoopInfo LI;
+    BranchProbabilityInfo BPI;
+    BlockFrequencyInfo BFI;
+    /// Estimated size, as accounted in the memory budget.
+    uint64_t Size = 0;
+  };
+
+  DenseMap<const Function *, std::unique_ptr<FunctionAnalyses>> Analyses;
+  /// Functions with analyses, from the oldest one.
+  std::deque<const Function *> Order;
+};
+
+}
+
+#endif
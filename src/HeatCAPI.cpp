@@ -0,0 +1,201 @@
+
+#include "HeatCAPI.h"
+#include "HeatBFIProvider.h"
+#include "HeatCFGWriter.h"
+#include "HeatCallGraphWriter.h"
+#include "HeatModuleLoader.h"
+#include "HeatProfile.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CBindingWrapping.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+struct HeatModule {
+  LLVMContext Context;
+  std::unique_ptr<Module> M;
+  HeatBFIProvider BFIs;
+  std::unique_ptr<HeatProfile> HP;
+  /// Function indices sorted by decreasing maximum frequency.
+  std::vector<unsigned> TopFunctions;
+  std::string Error;
+};
+
+}
+
+DEFINE_SIMPLE_CONVERSION_FUNCTIONS(HeatModule, HeatModuleRef)
+
+static size_t copyString(StringRef Str, char *Buf, size_t Size){
+  if (Buf && Size>0) {
+    size_t N = std::min(Str.size(),Size-1);
+    std::memcpy(Buf,Str.data(),N);
+    Buf[N] = '\0';
+  }
+  return Str.size();
+}
+
+static void fillFunctionInfo(const HeatProfile &HP, unsigned FI,
+                             HeatFunctionInfo *Out){
+  Out->Index = FI;
+  Out->NumBlocks = HP.blocks(FI).size();
+  Out->MaxFreq = HP.getFunctionMaxFreq(FI);
+  Out->EntryCount = HP.getFunctionEntryCount(FI);
+  Out->Heat = HP.getHeat(Out->MaxFreq);
+}
+
+HeatStatus HeatOpenModule(const char *BitcodePath, const char *ProfilePath,
+                          HeatModuleRef *Out){
+  HeatModule *HM = new HeatModule();
+  *Out = wrap(HM);
+
+  HM->M = loadHeatModule(BitcodePath, ProfilePath?ProfilePath:"",
+                         HM->Context, HM->Error);
+  if (!HM->M)
+    return HeatErrorBitcode;
+  if (!HM->Error.empty())
+    return HeatErrorProfile;
+  return HeatSuccess;
+}
+
+void HeatDisposeModule(HeatModuleRef M){
+  delete unwrap(M);
+}
+
+size_t HeatGetErrorMessage(HeatModuleRef M, char *Buf, size_t Size){
+  return copyString(unwrap(M)->Error,Buf,Size);
+}
+
+HeatStatus HeatCompute(HeatModuleRef M){
+  HeatModule *HM = unwrap(M);
+  if (!HM->M)
+    return HeatErrorBitcode;
+
+  HM->BFIs.clear();
+  HM->HP.reset(new HeatProfile(*HM->M,HM->BFIs));
+
+  const HeatProfile &HP = *HM->HP;
+  HM->TopFunctions.resize(HP.getNumFunctions());
+  for (unsigned FI = 0; FI<HP.getNumFunctions(); FI++)
+    HM->TopFunctions[FI] = FI;
+  std::stable_sort(HM->TopFunctions.begin(), HM->TopFunctions.end(),
+                   [&HP](unsigned A, unsigned B) {
+                     return HP.getFunctionMaxFreq(A)>HP.getFunctionMaxFreq(B);
+                   });
+  return HeatSuccess;
+}
+
+int HeatHasProfiling(HeatModuleRef M){
+  HeatModule *HM = unwrap(M);
+  return HM->HP?HM->HP->hasProfiling():0;
+}
+
+uint64_t HeatGetMaxFreq(HeatModuleRef M){
+  HeatModule *HM = unwrap(M);
+  return HM->HP?HM->HP->getMaxFreq():0;
+}
+
+unsigned HeatGetNumFunctions(HeatModuleRef M){
+  HeatModule *HM = unwrap(M);
+  return HM->HP?HM->HP->getNumFunctions():0;
+}
+
+size_t HeatGetFunctionName(HeatModuleRef M, unsigned FI, char *Buf,
+                           size_t Size){
+  HeatModule *HM = unwrap(M);
+  if (!HM->HP || FI>=HM->HP->getNumFunctions())
+    return copyString("",Buf,Size);
+  return copyString(HM->HP->getFunction(FI)->getName(),Buf,Size);
+}
+
+HeatStatus HeatGetFunctionInfo(HeatModuleRef M, unsigned FI,
+                               HeatFunctionInfo *Out){
+  HeatModule *HM = unwrap(M);
+  if (!HM->HP)
+    return HeatErrorNotComputed;
+  if (FI>=HM->HP->getNumFunctions())
+    return HeatErrorRange;
+  fillFunctionInfo(*HM->HP,FI,Out);
+  return HeatSuccess;
+}
+
+size_t HeatGetTopFunctions(HeatModuleRef M, HeatFunctionInfo *Buf, size_t N){
+  HeatModule *HM = unwrap(M);
+  if (!HM->HP)
+    return 0;
+  size_t Count = std::min(N,HM->TopFunctions.size());
+  for (size_t i = 0; i<Count; i++)
+    fillFunctionInfo(*HM->HP,HM->TopFunctions[i],&Buf[i]);
+  return Count;
+}
+
+size_t HeatGetBlocks(HeatModuleRef M, unsigned FI, unsigned First,
+                     HeatBlockInfo *Buf, size_t N){
+  HeatModule *HM = unwrap(M);
+  if (!HM->HP || FI>=HM->HP->getNumFunctions())
+    return 0;
+  const HeatProfile &HP = *HM->HP;
+  ArrayRef<uint64_t> Freqs = HP.blockFreqs(FI);
+  if (First>=Freqs.size())
+    return 0;
+  size_t Count = std::min(N,size_t(Freqs.size()-First));
+  unsigned FirstBI = HP.getFirstBlock(FI)+First;
+  for (size_t i = 0; i<Count; i++) {
+    Buf[i].Index = First+i;
+    Buf[i].NumSuccessors = HP.edgeFreqs(FirstBI+i).size();
+    Buf[i].Freq = Freqs[First+i];
+    Buf[i].Heat = HP.getHeat(Buf[i].Freq);
+  }
+  return Count;
+}
+
+size_t HeatGetEdgeFreqs(HeatModuleRef M, unsigned FI, unsigned BI,
+                        uint64_t *Buf, size_t N){
+  HeatModule *HM = unwrap(M);
+  if (!HM->HP || FI>=HM->HP->getNumFunctions())
+    return 0;
+  const HeatProfile &HP = *HM->HP;
+  if (BI>=HP.blocks(FI).size())
+    return 0;
+  ArrayRef<uint64_t> Freqs = HP.edgeFreqs(HP.getFirstBlock(FI)+BI);
+  std::copy_n(Freqs.begin(),std::min(N,Freqs.size()),Buf);
+  return Freqs.size();
+}
+
+HeatStatus HeatExport(HeatModuleRef M, HeatFormat Format, unsigned FI,
+                      const char *Path){
+  HeatModule *HM = unwrap(M);
+  if (!HM->HP)
+    return HeatErrorNotComputed;
+  const HeatProfile &HP = *HM->HP;
+  if (Format!=HeatFormatCallGraph && FI>=HP.getNumFunctions())
+    return HeatErrorRange;
+
+  removeHeatOutputFile(Path);
+  std::error_code EC;
+  raw_fd_ostream File(Path, EC, sys::fs::F_Text);
+  if (EC) {
+    HM->Error = EC.message();
+    return HeatErrorIO;
+  }
+
+  if (Format==HeatFormatCallGraph) {
+    writeHeatCallGraph(File,HP,HeatCallGraphOptions());
+  } else {
+    HeatCFGOptions Opts;
+    Opts.Simple = (Format==HeatFormatCFGOnly);
+    writeHeatCFG(File,*HP.getFunction(FI),HP,Opts);
+  }
+  return HeatSuccess;
+}
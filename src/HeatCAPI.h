@@ -0,0 +1,138 @@
+/*===-- HeatCAPI.h - C interface to the heat library --------------*- C -*-===*\
+|*                                                                            *|
+|*                     The LLVM Compiler Infrastructure                       *|
+|*                                                                            *|
+|* This file is distributed under the University of Illinois Open Source      *|
+|* License. See LICENSE.TXT for details.                                      *|
+|*                                                                            *|
+|*===----------------------------------------------------------------------===*|
+|*                                                                            *|
+|* This header declares the C interface to the heat library, for tools        *|
+|* written in other languages.                                                *|
+|*                                                                            *|
+|* A HeatModuleRef owns a module loaded from bitcode (optionally annotated    *|
+|* with a .profdata file) and its heat profile. All the query functions       *|
+|* write into buffers provided by the caller, so no memory allocated by the   *|
+|* library ever crosses this interface.                                       *|
+|*                                                                            *|
+\*===----------------------------------------------------------------------===*/
+
+#ifndef HEAT_C_HEATCAPI_H
+#define HEAT_C_HEATCAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct HeatOpaqueModule *HeatModuleRef;
+
+typedef enum {
+  HeatSuccess = 0,
+  /* The bitcode file could not be read or parsed. */
+  HeatErrorBitcode,
+  /* The profile could not be applied to the module. */
+  HeatErrorProfile,
+  /* HeatCompute has not been called on the module. */
+  HeatErrorNotComputed,
+  /* A function or block index is out of range. */
+  HeatErrorRange,
+  /* An output file could not be written. */
+  HeatErrorIO
+} HeatStatus;
+
+typedef enum {
+  /* Heat CFG of a function, with the instructions of each block. */
+  HeatFormatCFG,
+  /* Heat CFG of a function, with only the names of the blocks. */
+  HeatFormatCFGOnly,
+  /* Heat call graph of the module. */
+  HeatFormatCallGraph
+} HeatFormat;
+
+typedef struct {
+  unsigned Index;
+  unsigned NumBlocks;
+  uint64_t MaxFreq;
+  uint64_t EntryCount;
+  /* MaxFreq relative to the module maximum, in [0,1]. */
+  double Heat;
+} HeatFunctionInfo;
+
+typedef struct {
+  unsigned Index;
+  unsigned NumSuccessors;
+  uint64_t Freq;
+  /* Freq relative to the module maximum, in [0,1]. */
+  double Heat;
+} HeatBlockInfo;
+
+/**
+ * Loads the module in \p BitcodePath and, if \p ProfilePath is not null,
+ * annotates it with the instrumentation profile in that file. On failure,
+ * \p *Out is still set, so that the error message can be retrieved, and must
+ * be disposed.
+ */
+HeatStatus HeatOpenModule(const char *BitcodePath, const char *ProfilePath,
+                          HeatModuleRef *Out);
+
+void HeatDisposeModule(HeatModuleRef M);
+
+/**
+ * Copies the message of the last error into \p Buf, truncated to \p Size
+ * bytes (including the terminating null), and returns its full length.
+ */
+size_t HeatGetErrorMessage(HeatModuleRef M, char *Buf, size_t Size);
+
+/** Computes the heat profile of the module. */
+HeatStatus HeatCompute(HeatModuleRef M);
+
+int HeatHasProfiling(HeatModuleRef M);
+uint64_t HeatGetMaxFreq(HeatModuleRef M);
+unsigned HeatGetNumFunctions(HeatModuleRef M);
+
+/**
+ * Copies the name of function \p FI into \p Buf, truncated to \p Size bytes
+ * (including the terminating null), and returns its full length.
+ */
+size_t HeatGetFunctionName(HeatModuleRef M, unsigned FI, char *Buf,
+                           size_t Size);
+
+HeatStatus HeatGetFunctionInfo(HeatModuleRef M, unsigned FI,
+                               HeatFunctionInfo *Out);
+
+/**
+ * Writes the \p N hottest functions into \p Buf, hottest first, and returns
+ * the number of entries written.
+ */
+size_t HeatGetTopFunctions(HeatModuleRef M, HeatFunctionInfo *Buf, size_t N);
+
+/**
+ * Writes up to \p N blocks of function \p FI into \p Buf, starting from its
+ * block \p First, and returns the number of entries written. Blocks are
+ * iterated in chunks by advancing \p First until 0 is returned.
+ */
+size_t HeatGetBlocks(HeatModuleRef M, unsigned FI, unsigned First,
+                     HeatBlockInfo *Buf, size_t N);
+
+/**
+ * Writes the frequencies of the outgoing edges of block \p BI of function
+ * \p FI into \p Buf and returns the number of successors of the block.
+ */
+size_t HeatGetEdgeFreqs(HeatModuleRef M, unsigned FI, unsigned BI,
+                        uint64_t *Buf, size_t N);
+
+/**
+ * Writes the heat graph in the given format to \p Path. \p FI is the
+ * function index for the CFG formats and is ignored for the call graph.
+ */
+HeatStatus HeatExport(HeatModuleRef M, HeatFormat Format, unsigned FI,
+                      const char *Path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -12,39 +12,21 @@
 // CFG for that function coloured with heat map depending on the basic block
 // frequency.
 //
-// This file defines external functions that can be called to explicitly
-// instantiate the CFG printer.
+// The passes are defined in HeatCFGPrinterPass.h, with the functions that can
+// be called to explicitly instantiate them. This file declares how their
+// options are taken from the command line.
 //
 //===----------------------------------------------------------------------===//
 
 #ifndef LLVM_ANALYSIS_HEATCFGPRINTER_H
 #define LLVM_ANALYSIS_HEATCFGPRINTER_H
 
-#include "llvm/IR/Module.h"
-#include "llvm/Pass.h"
+#include "HeatCFGPrinterPass.h"
 
-using namespace llvm;
+namespace llvm {
 
-namespace {
-
-class HeatCFGPrinterPass : public ModulePass {
-public:
-  static char ID;
-  HeatCFGPrinterPass() : ModulePass(ID) {}
-
-  void getAnalysisUsage(AnalysisUsage &AU) const;
-  bool runOnModule(Module &M) override;
-};
-
-class HeatCFGOnlyPrinterPass : public ModulePass {
-public:
-  static char ID;
-  HeatCFGOnlyPrinterPass() : ModulePass(ID) {}
-
-  void getAnalysisUsage(AnalysisUsage &AU) const;
-  bool runOnModule(Module &M) override;
-
-};
+/// Returns the options given on the command line.
+HeatCFGPrinterOptions getHeatCFGPrinterOptions(bool Simple);
 
 }
 
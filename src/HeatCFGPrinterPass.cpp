@@ -0,0 +1,166 @@
+
+#include "HeatCFGPrinterPass.h"
+#include "HeatAsyncWriter.h"
+#include "HeatCFGWriter.h"
+#include "HeatDataCache.h"
+#include "HeatIndex.h"
+#include "HeatMemoryBudget.h"
+#include "HeatOutputStore.h"
+#include "HeatSummary.h"
+#include "HeatUtils.h"
+
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+static std::unique_ptr<HeatAsyncWriter>
+getHeatAsyncWriter(const HeatCFGPrinterOptions &Opts){
+  if (!Opts.AsyncQueueSize)
+    return nullptr;
+  return std::unique_ptr<HeatAsyncWriter>(
+      new HeatAsyncWriter(Opts.AsyncQueueSize));
+}
+
+static void finishHeatAsyncWriter(HeatAsyncWriter *Writer){
+  if (!Writer)
+    return;
+  for (const std::string &Filename : Writer->finish())
+    HeatLog() << "Error writing '" << Filename << "'!\n";
+}
+
+static std::unique_ptr<HeatOutputStore>
+getHeatOutputStore(const HeatCFGPrinterOptions &Opts){
+  if (Opts.StoreDir.empty())
+    return nullptr;
+  std::unique_ptr<HeatOutputStore> Store(new HeatOutputStore(Opts.StoreDir));
+  if (Opts.StoreGCDays) {
+    unsigned Removed =
+        Store->collectGarbage(std::chrono::hours(24*Opts.StoreGCDays));
+    HeatLog() << "Removed " << Removed << " unused files from '"
+              << Opts.StoreDir << "'\n";
+  }
+  return Store;
+}
+
+static void writeHeatIndex(HeatIndex &Index, StringRef Filename){
+  Index.sort();
+  writeHeatReport(Filename,[&](raw_ostream &OS) { Index.print(OS); });
+}
+
+static void writeHeatCFGShardToDotFile(Module &M,
+       function_ref<BlockFrequencyInfo *(Function &)> LookupBFI,
+       const HeatCFGPrinterOptions &PrinterOpts, HeatCFGOptions Opts){
+  HeatShard Shard;
+  if (!HeatShard::parse(PrinterOpts.Shard,Shard))
+    report_fatal_error(Twine("invalid heat shard '") + PrinterOpts.Shard +
+                       "', expected i/N");
+
+  // The maximum frequency of the module is taken from the summary, so that
+  // the frequencies of the functions of other shards are never computed.
+  if (!PrinterOpts.SummaryFile.empty()) {
+    HeatSummary Summary;
+    std::string Error;
+    if (!HeatSummary::read(PrinterOpts.SummaryFile,Summary,Error))
+      report_fatal_error(Twine("cannot read heat summary '") +
+                         PrinterOpts.SummaryFile + "': " + Error);
+    Opts.MaxFreq = Summary.MaxFreq;
+  } else if (!Opts.PerFunction) {
+    HeatProfile &HP = HeatDataCache::instance().get(M,LookupBFI,
+                                                    PrinterOpts.Profile);
+    Opts.MaxFreq = HP.getMaxFreq();
+  }
+
+  HeatProfileOptions ProfileOpts = PrinterOpts.Profile;
+  ProfileOpts.Filter = [Shard](const Function &F) {
+    return Shard.contains(F);
+  };
+  HeatProfile HP(M,LookupBFI,ProfileOpts);
+  // The profile of the shard is not cached, but is accounted for as well.
+  HeatMemoryBudget &Budget = HeatMemoryBudget::instance();
+  Budget.acquire(HP.getMemorySize());
+
+  std::unique_ptr<HeatOutputStore> Store = getHeatOutputStore(PrinterOpts);
+  Opts.Store = Store.get();
+  std::unique_ptr<HeatAsyncWriter> Writer = getHeatAsyncWriter(PrinterOpts);
+  Opts.Writer = Writer.get();
+
+  HeatIndex Index;
+  Index.Shard = Shard;
+  Index.MaxFreq = Opts.MaxFreq?Opts.MaxFreq:HP.getMaxFreq();
+  writeHeatCFGToDotFiles(HP,Opts,&Index);
+  finishHeatAsyncWriter(Writer.get());
+  Budget.release(HP.getMemorySize());
+  writeHeatIndex(Index,getHeatOutputFilename("heatcfg." + Shard.str(),
+                                             Opts.OutputTag,".index"));
+}
+
+static void writeHeatCFGToDotFile(Module &M,
+       function_ref<BlockFrequencyInfo *(Function &)> LookupBFI,
+       const HeatCFGPrinterOptions &PrinterOpts){
+  HeatCFGOptions Opts = PrinterOpts.CFG;
+  if (PrinterOpts.UniqueOutput)
+    Opts.OutputTag = getUniqueHeatOutputTag();
+  // The budget also covers the computation of the frequencies.
+  if (PrinterOpts.TimeBudget)
+    Opts.Deadline = std::chrono::steady_clock::now() +
+                    std::chrono::seconds(PrinterOpts.TimeBudget);
+  if (!PrinterOpts.Shard.empty()) {
+    writeHeatCFGShardToDotFile(M,LookupBFI,PrinterOpts,Opts);
+    return;
+  }
+  std::unique_ptr<HeatOutputStore> Store = getHeatOutputStore(PrinterOpts);
+  Opts.Store = Store.get();
+  std::unique_ptr<HeatAsyncWriter> Writer = getHeatAsyncWriter(PrinterOpts);
+  Opts.Writer = Writer.get();
+
+  HeatProfile &HP = HeatDataCache::instance().get(M,LookupBFI,
+                                                  PrinterOpts.Profile);
+  if (!PrinterOpts.TimeBudget) {
+    writeHeatCFGToDotFiles(HP,Opts);
+    finishHeatAsyncWriter(Writer.get());
+    return;
+  }
+
+  // With a time budget, the index tells which functions were covered.
+  HeatIndex Index;
+  Index.MaxFreq = Opts.MaxFreq?Opts.MaxFreq:HP.getMaxFreq();
+  writeHeatCFGToDotFiles(HP,Opts,&Index);
+  finishHeatAsyncWriter(Writer.get());
+  writeHeatIndex(Index,getHeatOutputFilename("heatcfg",Opts.OutputTag,
+                                             ".index"));
+}
+
+namespace llvm {
+
+char HeatCFGPrinterPass::ID = 0;
+char HeatCFGOnlyPrinterPass::ID = 0;
+
+bool HeatCFGPrinterPass::runOnModule(Module &M) {
+  ::writeHeatCFGToDotFile(M,LookupBFI,Opts);
+  return false;
+}
+
+bool HeatCFGOnlyPrinterPass::runOnModule(Module &M) {
+  ::writeHeatCFGToDotFile(M,LookupBFI,Opts);
+  return false;
+}
+
+ModulePass *createHeatCFGPrinterPass(const HeatCFGPrinterOptions &Opts){
+  return new HeatCFGPrinterPass(Opts);
+}
+
+ModulePass *createHeatCFGOnlyPrinterPass(const HeatCFGPrinterOptions &Opts){
+  return new HeatCFGOnlyPrinterPass(Opts);
+}
+
+}
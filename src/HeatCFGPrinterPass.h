@@ -0,0 +1,97 @@
+//===-- HeatCFGPrinterPass.h - Heat CFG printer passes ----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the 'dot-heat-cfg' and 'dot-heat-cfg-only' passes, which
+// emit the heatcfg.<fnname>.dot file of each function of the module, and the
+// functions creating them with their own options.
+//
+// The passes are part of the core library, so that tools can create them.
+// Their default constructors take the options from the command line, and are
+// only defined in the HeatPrinter plugin, which registers the passes.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATCFGPRINTERPASS_H
+#define LLVM_ANALYSIS_HEATCFGPRINTERPASS_H
+
+#include "HeatCFGWriter.h"
+#include "HeatProfile.h"
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+#include <string>
+
+using namespace llvm;
+
+namespace llvm {
+
+/// Options of the heat CFG printers. The passes created from the command
+/// line take them from their options, while the passes created with
+/// createHeatCFGPrinterPass have their own, e.g. for each backend of a
+/// parallel LTO build.
+struct HeatCFGPrinterOptions {
+  HeatCFGOptions CFG;
+  HeatProfileOptions Profile;
+  /// Only print the CFGs of the functions in this shard, given as "i/N".
+  std::string Shard;
+  /// Heat summary with the maximum frequency of the module, used when
+  /// printing a shard.
+  std::string SummaryFile;
+  /// Content-addressed store the CFG files are reused from.
+  std::string StoreDir;
+  /// Remove the files of the store not used for this many days.
+  unsigned StoreGCDays = 0;
+  /// Write the CFG files on a separate thread, with this many files pending
+  /// at most.
+  unsigned AsyncQueueSize = 0;
+  /// Write the CFGs from the hottest function, and stop after this many
+  /// seconds.
+  unsigned TimeBudget = 0;
+  /// Insert a unique tag in the names of the files written for each module.
+  bool UniqueOutput = false;
+};
+
+ModulePass *createHeatCFGPrinterPass(const HeatCFGPrinterOptions &Opts);
+
+/// Creates a CFG printer pass with simple labels, whatever \p Opts says.
+ModulePass *createHeatCFGOnlyPrinterPass(const HeatCFGPrinterOptions &Opts);
+
+class HeatCFGPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatCFGPrinterPass();
+  explicit HeatCFGPrinterPass(const HeatCFGPrinterOptions &Opts)
+      : HeatReportPass(ID), Opts(Opts) {}
+
+  bool runOnModule(Module &M) override;
+
+private:
+  HeatCFGPrinterOptions Opts;
+};
+
+class HeatCFGOnlyPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatCFGOnlyPrinterPass();
+  explicit HeatCFGOnlyPrinterPass(const HeatCFGPrinterOptions &Opts)
+      : HeatReportPass(ID), Opts(Opts) {
+    this->Opts.CFG.Simple = true;
+  }
+
+  bool runOnModule(Module &M) override;
+
+private:
+  HeatCFGPrinterOptions Opts;
+};
+
+}
+
+#endif
@@ -0,0 +1,590 @@
+
+#include "HeatCFGWriter.h"
+#include "HeatMemoryBudget.h"
+#include "HeatPagination.h"
+#include "HeatUtils.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Analysis/CFGPrinter.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/ModuleSlotTracker.h"
+#include "llvm/Support/DOTGraphTraits.h"
+#include "llvm/Support/GraphWriter.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <sstream>
+#include <vector>
+
+namespace llvm {
+
+/// Data of the outgoing edges of a block that is shared by all of them, so
+/// that labelling the edges of a block is linear in their number.
+struct HeatEdgeInfo {
+   /// Sum of the frequencies of the successors.
+   uint64_t SuccFreqTotal = 0;
+   /// Source labels of the edges of a switch, by successor index.
+   std::vector<std::string> CaseLabels;
+   /// Edge standing for all the edges to the same successor, by successor
+   /// index. Each edge stands for itself unless parallel edges are merged.
+   std::vector<unsigned> Leader;
+   /// Per leader edge, the number of edges and the sum of their raw weights.
+   std::vector<unsigned> NumMerged;
+   std::vector<uint64_t> RawWeight;
+   bool HasRawWeights = false;
+};
+
+class HeatCFGInfo {
+private:
+   const HeatProfile *HP;
+   const Function *F;
+   uint64_t maxFreq;
+   const HeatCFGOptions *Opts;
+   std::unique_ptr<ModuleSlotTracker> MST;
+   const BasicBlock *EdgeInfoBB = nullptr;
+   HeatEdgeInfo EdgeInfo;
+public:
+   HeatCFGInfo(const Function *F, const HeatProfile *HP, uint64_t maxFreq,
+               const HeatCFGOptions *Opts){
+      this->HP = HP;
+      this->F = F;
+      this->maxFreq = maxFreq;
+      this->Opts = Opts;
+   }
+
+   const HeatProfile *getProfile(){ return HP; }
+
+   const Function *getF(){ return this->F; }
+
+   uint64_t getMaxFreq() { return maxFreq; }
+
+   const HeatCFGOptions &getOptions() { return *Opts; }
+
+   uint64_t getFreq(const BasicBlock *BB){
+      return HP->getBlockFreq(BB);
+   }
+
+   /// Slot numbering of the function, shared by the labels of all blocks.
+   /// Printing an unnamed value without it numbers the whole function again.
+   ModuleSlotTracker &getSlotTracker(){
+      if (!MST) {
+         MST.reset(new ModuleSlotTracker(F->getParent(), false));
+         MST->incorporateFunction(*F);
+      }
+      return *MST;
+   }
+
+   /// Returns the edge data of \p BB. Only the last block is kept, as the
+   /// edges of a block are always written together.
+   const HeatEdgeInfo &getEdgeInfo(const BasicBlock *BB){
+      if (EdgeInfoBB==BB)
+         return EdgeInfo;
+      EdgeInfoBB = BB;
+      EdgeInfo = HeatEdgeInfo();
+
+      const TerminatorInst *TI = BB->getTerminator();
+      unsigned NumSuccs = TI->getNumSuccessors();
+      for (unsigned i = 0; i<NumSuccs; i++)
+         EdgeInfo.SuccFreqTotal += getFreq(TI->getSuccessor(i));
+
+      std::vector<uint64_t> Weights(NumSuccs,0);
+      MDNode *WeightsNode = TI->getMetadata(LLVMContext::MD_prof);
+      if (WeightsNode && WeightsNode->getNumOperands()==NumSuccs+1) {
+         MDString *MDName = dyn_cast<MDString>(WeightsNode->getOperand(0));
+         if (MDName && MDName->getString()=="branch_weights") {
+            EdgeInfo.HasRawWeights = true;
+            for (unsigned i = 0; i<NumSuccs; i++) {
+               ConstantInt *Weight = mdconst::dyn_extract<ConstantInt>(
+                   WeightsNode->getOperand(i+1));
+               EdgeInfo.HasRawWeights &= (Weight!=nullptr);
+               if (Weight)
+                  Weights[i] = Weight->getZExtValue();
+            }
+         }
+      }
+
+      const SwitchInst *SI = dyn_cast<SwitchInst>(TI);
+      if (SI) {
+         EdgeInfo.CaseLabels.resize(NumSuccs);
+         EdgeInfo.CaseLabels[0] = "def";
+         for (auto Case : SI->cases()) {
+            std::string &Label = EdgeInfo.CaseLabels[Case.getSuccessorIndex()];
+            raw_string_ostream OS(Label);
+            OS << Case.getCaseValue()->getValue();
+         }
+      }
+
+      EdgeInfo.Leader.resize(NumSuccs);
+      EdgeInfo.NumMerged.assign(NumSuccs,0);
+      EdgeInfo.RawWeight.assign(NumSuccs,0);
+      DenseMap<const BasicBlock *, unsigned> FirstEdge;
+      for (unsigned i = 0; i<NumSuccs; i++) {
+         unsigned Leader = i;
+         if (SI && Opts->MergeSwitchEdges)
+            Leader = FirstEdge.insert(
+                std::make_pair(TI->getSuccessor(i),i)).first->second;
+         EdgeInfo.Leader[i] = Leader;
+         EdgeInfo.NumMerged[Leader]++;
+         EdgeInfo.RawWeight[Leader] += Weights[i];
+         if (Leader!=i) {
+            EdgeInfo.CaseLabels[Leader] += "," + EdgeInfo.CaseLabels[i];
+            EdgeInfo.CaseLabels[i].clear();
+         }
+      }
+      return EdgeInfo;
+   }
+};
+
+template <> struct GraphTraits<HeatCFGInfo *> :
+  public GraphTraits<const BasicBlock*> {
+  static NodeRef getEntryNode(HeatCFGInfo *heatCFG) {
+    return &(heatCFG->getF()->getEntryBlock());
+  }
+
+  // nodes_iterator/begin/end - Allow iteration over all nodes in the graph
+  using nodes_iterator = pointer_iterator<Function::const_iterator>;
+
+  static nodes_iterator nodes_begin(HeatCFGInfo *heatCFG) {
+    return nodes_iterator(heatCFG->getF()->begin());
+  }
+
+  static nodes_iterator nodes_end(HeatCFGInfo *heatCFG) {
+    return nodes_iterator(heatCFG->getF()->end());
+  }
+
+  static size_t size(HeatCFGInfo *heatCFG) { return heatCFG->getF()->size(); }
+};
+
+template<>
+struct DOTGraphTraits<HeatCFGInfo *> : public DefaultDOTGraphTraits {
+
+  DOTGraphTraits (bool isSimple=false) : DefaultDOTGraphTraits(isSimple) {}
+
+  // The graph is not passed to getEdgeSourceLabel, so it is recorded here,
+  // as the graph name is always requested before any node is written.
+  HeatCFGInfo *CurrentGraph = nullptr;
+
+  std::string getGraphName(HeatCFGInfo *heatCFG) {
+    CurrentGraph = heatCFG;
+    return "Heat CFG for '" + heatCFG->getF()->getName().str() + "' function";
+  }
+
+  static std::string getSimpleNodeLabel(const BasicBlock *Node,
+                                        HeatCFGInfo *heatCFG) {
+    if (!Node->getName().empty())
+      return Node->getName().str();
+
+    std::string Str;
+    raw_string_ostream OS(Str);
+
+    Node->printAsOperand(OS, false, heatCFG->getSlotTracker());
+    return OS.str();
+  }
+
+  static std::string getCompleteNodeLabel(const BasicBlock *Node,
+                                          HeatCFGInfo *heatCFG) {
+    enum { MaxColumns = 80 };
+    std::string Str;
+    raw_string_ostream OS(Str);
+
+    ModuleSlotTracker &MST = heatCFG->getSlotTracker();
+    if (Node->getName().empty()) {
+      Node->printAsOperand(OS, false, MST);
+      OS << ":";
+    }
+
+    // BasicBlock::print hides the overload taking a slot tracker.
+    static_cast<const Value *>(Node)->print(OS, MST);
+    std::string OutStr = OS.str();
+    if (OutStr[0] == '\n') OutStr.erase(OutStr.begin());
+
+    // Process string output to make it nicer...
+    unsigned ColNum = 0;
+    unsigned LastSpace = 0;
+    for (unsigned i = 0; i != OutStr.length(); ++i) {
+      if (OutStr[i] == '\n') {                            // Left justify
+        OutStr[i] = '\\';
+        OutStr.insert(OutStr.begin()+i+1, 'l');
+        ColNum = 0;
+        LastSpace = 0;
+      } else if (OutStr[i] == ';') {                      // Delete comments!
+        unsigned Idx = OutStr.find('\n', i+1);            // Find end of line
+        OutStr.erase(OutStr.begin()+i, OutStr.begin()+Idx);
+        --i;
+      } else if (ColNum == MaxColumns) {                  // Wrap lines.
+        // Wrap very long names even though we can't find a space.
+        if (!LastSpace)
+          LastSpace = i;
+        OutStr.insert(LastSpace, "\\l...");
+        ColNum = i - LastSpace;
+        LastSpace = 0;
+        i += 3; // The loop will advance 'i' again.
+      }
+      else
+        ++ColNum;
+      if (OutStr[i] == ' ')
+        LastSpace = i;
+    }
+    return OutStr;
+  }
+
+  std::string getNodeLabel(const BasicBlock *Node,
+                           HeatCFGInfo *Graph) {
+    if (isSimple())
+      return getSimpleNodeLabel(Node, Graph);
+    else
+      return getCompleteNodeLabel(Node, Graph);
+  }
+
+  std::string getEdgeSourceLabel(const BasicBlock *Node,
+                                 succ_const_iterator I) {
+    // Label source of conditional branches with "T" or "F"
+    if (const BranchInst *BI = dyn_cast<BranchInst>(Node->getTerminator()))
+      if (BI->isConditional())
+        return (I == succ_begin(Node)) ? "T" : "F";
+
+    // Label source of switch edges with the associated values.
+    if (isa<SwitchInst>(Node->getTerminator()) && CurrentGraph)
+      return CurrentGraph->getEdgeInfo(Node).CaseLabels[I.getSuccessorIndex()];
+    return "";
+  }
+
+  /// Display the raw branch weights from PGO.
+  std::string getEdgeAttributes(const BasicBlock *Node, succ_const_iterator I,
+                                HeatCFGInfo *Graph) {
+
+    const HeatEdgeInfo &EdgeInfo = Graph->getEdgeInfo(Node);
+    unsigned OpNo = I.getSuccessorIndex();
+
+    if (Graph->getOptions().NoEdgeWeight)
+      return "";
+
+    const TerminatorInst *TI = Node->getTerminator();
+    if (TI->getNumSuccessors() == 1)
+      return "";
+
+    std::string Attrs = "";
+
+    if (Graph->getOptions().RawEdgeWeight) {
+       if (!EdgeInfo.HasRawWeights)
+         return "";
+
+       // Prepend a 'W' to indicate that this is a weight rather than the actual
+       // profile count (due to scaling).
+       Attrs = "label=\"W:" + std::to_string(EdgeInfo.RawWeight[OpNo]) + "\"";
+    } else {
+       uint64_t total = EdgeInfo.SuccFreqTotal;
+
+       if (OpNo >= TI->getNumSuccessors())
+         return "";
+
+       BasicBlock *SuccBB = TI->getSuccessor(OpNo);
+
+       double val = 0.0;
+       if (Graph->getFreq(SuccBB)>0) {
+         double freq = Graph->getFreq(SuccBB);
+         freq *= EdgeInfo.NumMerged[OpNo];
+         val = (int(round((freq/double(total))*10000)))/100.0;
+       }
+
+       std::stringstream ss;
+       ss.precision(2);
+       ss << std::fixed << val;
+       Attrs = "label=\"" + ss.str() + "%\"";
+    }
+    return Attrs;
+  }
+
+  std::string getNodeAttributes(const BasicBlock *Node, HeatCFGInfo *Graph) {
+    uint64_t freq = Graph->getFreq(Node);
+    std::string color = getHeatColor(freq, Graph->getMaxFreq());
+    std::string edgeColor = (freq<=(Graph->getMaxFreq()/2))?
+                            (getHeatColor(0)):(getHeatColor(1));
+
+    std::string attrs = "color=\"" + edgeColor +
+                        "ff\", style=filled, fillcolor=\"" + color + "80\"";
+
+    return attrs;
+  }  
+};
+
+/// Heat CFG whose parallel switch edges are merged into the first one. Its
+/// graph traits skip the other edges, so that they are not even written.
+class HeatMergedCFGInfo : public HeatCFGInfo {
+public:
+   using HeatCFGInfo::HeatCFGInfo;
+};
+
+/// Iterates over the successors of a block, skipping the edges of a switch
+/// to a successor already reached by an earlier edge.
+class HeatMergedSuccIterator : public succ_const_iterator {
+  /// Per successor index, true if the edge is merged into an earlier one.
+  std::shared_ptr<std::vector<bool>> Merged;
+
+  void skipMerged(){
+    while (Merged && getSuccessorIndex()<Merged->size() &&
+           (*Merged)[getSuccessorIndex()])
+      succ_const_iterator::operator++();
+  }
+
+public:
+  HeatMergedSuccIterator(succ_const_iterator I,
+                         std::shared_ptr<std::vector<bool>> Merged)
+      : succ_const_iterator(I), Merged(std::move(Merged)) {
+    skipMerged();
+  }
+
+  HeatMergedSuccIterator &operator++(){
+    succ_const_iterator::operator++();
+    skipMerged();
+    return *this;
+  }
+};
+
+template <> struct GraphTraits<HeatMergedCFGInfo *> :
+  public GraphTraits<HeatCFGInfo *> {
+  using ChildIteratorType = HeatMergedSuccIterator;
+
+  static ChildIteratorType child_begin(NodeRef BB) {
+    std::shared_ptr<std::vector<bool>> Merged;
+    if (const SwitchInst *SI = dyn_cast<SwitchInst>(BB->getTerminator())) {
+      unsigned NumSuccs = SI->getNumSuccessors();
+      Merged = std::make_shared<std::vector<bool>>(NumSuccs);
+      SmallPtrSet<const BasicBlock *, 16> Seen;
+      for (unsigned i = 0; i<NumSuccs; i++)
+        (*Merged)[i] = !Seen.insert(SI->getSuccessor(i)).second;
+    }
+    return HeatMergedSuccIterator(succ_begin(BB),std::move(Merged));
+  }
+
+  static ChildIteratorType child_end(NodeRef BB) {
+    return HeatMergedSuccIterator(succ_end(BB),nullptr);
+  }
+};
+
+template<>
+struct DOTGraphTraits<HeatMergedCFGInfo *> :
+  public DOTGraphTraits<HeatCFGInfo *> {
+  DOTGraphTraits (bool isSimple=false)
+      : DOTGraphTraits<HeatCFGInfo *>(isSimple) {}
+};
+
+static std::string getHeatCFGPrefix(const Function &F){
+  return ("heatcfg." + F.getName()).str();
+}
+
+std::string getHeatCFGFilename(const Function &F, StringRef Tag){
+  return getHeatOutputFilename(getHeatCFGPrefix(F),Tag,".dot");
+}
+
+std::string getHeatCFGOutputFilename(const Function &F,
+                                     const HeatCFGOptions &Opts){
+  if (Opts.PageSize && F.size()>Opts.PageSize)
+    return getHeatOutputFilename(getHeatCFGPrefix(F),Opts.OutputTag,
+                                 ".index.dot");
+  return getHeatCFGFilename(F,Opts.OutputTag);
+}
+
+static uint64_t getHeatCFGMaxFreq(const Function &F, const HeatProfile &HP,
+                                  const HeatCFGOptions &Opts){
+  if (Opts.PerFunction)
+    return HP.getFunctionMaxFreq(&F);
+  return Opts.MaxFreq?Opts.MaxFreq:HP.getMaxFreq();
+}
+
+void writeHeatCFG(raw_ostream &OS, const Function &F, const HeatProfile &HP,
+                  const HeatCFGOptions &Opts){
+  uint64_t maxFreq = getHeatCFGMaxFreq(F,HP,Opts);
+  if (Opts.MergeSwitchEdges) {
+    HeatMergedCFGInfo heatCFGInfo(&F,&HP,maxFreq,&Opts);
+    WriteGraph(OS, &heatCFGInfo, Opts.Simple);
+    return;
+  }
+  HeatCFGInfo heatCFGInfo(&F,&HP,maxFreq,&Opts);
+  WriteGraph(OS, &heatCFGInfo, Opts.Simple);
+}
+
+void writeHeatCFGPages(const Function &F, const HeatProfile &HP,
+                       const HeatCFGOptions &Opts){
+  uint64_t maxFreq = getHeatCFGMaxFreq(F,HP,Opts);
+  HeatCFGInfo heatCFGInfo(&F,&HP,maxFreq,&Opts);
+  DOTGraphTraits<HeatCFGInfo *> DTraits(Opts.Simple);
+  DOTGraphTraits<HeatCFGInfo *> SimpleTraits(true);
+  HeatMemoryBudget &Budget = HeatMemoryBudget::instance();
+  uint64_t LabelBytes = 0;
+
+  HeatPageGraph G;
+  G.Title = DTraits.getGraphName(&heatCFGInfo);
+  G.MaxFreq = maxFreq;
+  G.RecordNodes = true;
+
+  DenseMap<const BasicBlock *, unsigned> NodeIndex;
+  for (const BasicBlock &BB : F) {
+    NodeIndex[&BB] = G.Nodes.size();
+    HeatPageGraph::Node Node;
+    Node.Name = DTraits.getSimpleNodeLabel(&BB,&heatCFGInfo);
+    // The labels of all the blocks are held until the pages are written, so
+    // they are reduced to the block names once the budget runs low.
+    if (Budget.isNearLimit())
+      Node.Label = SimpleTraits.getNodeLabel(&BB,&heatCFGInfo);
+    else
+      Node.Label = DTraits.getNodeLabel(&BB,&heatCFGInfo);
+    Node.Attrs = DTraits.getNodeAttributes(&BB,&heatCFGInfo);
+    Node.Freq = heatCFGInfo.getFreq(&BB);
+    uint64_t Bytes = Node.Name.size()+Node.Label.size()+Node.Attrs.size();
+    Budget.acquire(Bytes);
+    LabelBytes += Bytes;
+    G.Nodes.push_back(Node);
+  }
+
+  std::vector<unsigned> EdgeIndex;
+  for (const BasicBlock &BB : F) {
+    const HeatEdgeInfo &EdgeInfo = heatCFGInfo.getEdgeInfo(&BB);
+    EdgeIndex.resize(EdgeInfo.Leader.size());
+    for (succ_const_iterator SI = succ_begin(&BB), SE = succ_end(&BB);
+         SI!=SE; ++SI) {
+      unsigned SuccIdx = SI.getSuccessorIndex();
+      uint64_t Freq = HP.getEdgeFreq(&BB,SuccIdx);
+      // Merged parallel edges only add their heat to the first one.
+      if (EdgeInfo.Leader[SuccIdx]!=SuccIdx) {
+        G.Edges[EdgeIndex[EdgeInfo.Leader[SuccIdx]]].Freq += Freq;
+        continue;
+      }
+      EdgeIndex[SuccIdx] = G.Edges.size();
+      HeatPageGraph::Edge Edge;
+      Edge.Src = NodeIndex[&BB];
+      Edge.Dst = NodeIndex[*SI];
+      Edge.Freq = Freq;
+      Edge.Attrs = DTraits.getEdgeAttributes(&BB,SI,&heatCFGInfo);
+      std::string SrcLabel = DTraits.getEdgeSourceLabel(&BB,SI);
+      if (!SrcLabel.empty()) {
+        if (!Edge.Attrs.empty())
+          Edge.Attrs += ",";
+        Edge.Attrs += "taillabel=\"" + DOT::EscapeString(SrcLabel) + "\"";
+      }
+      Budget.acquire(Edge.Attrs.size());
+      LabelBytes += Edge.Attrs.size();
+      G.Edges.push_back(Edge);
+    }
+  }
+
+  writeHeatGraphPages(G,Opts.PageSize,
+                      getHeatOutputFilename(getHeatCFGPrefix(F),
+                                            Opts.OutputTag,""));
+  Budget.release(LabelBytes);
+}
+
+/// Returns the options that change the contents of a CFG file, as part of
+/// its key in the output store.
+static std::string getHeatCFGOptionsKey(const HeatCFGOptions &Opts){
+  std::string Key = "cfg";
+  Key += Opts.PerFunction?" per-function":"";
+  Key += Opts.RawEdgeWeight?" raw-weight":"";
+  Key += Opts.NoEdgeWeight?" no-weight":"";
+  Key += Opts.Simple?" simple":"";
+  Key += Opts.MergeSwitchEdges?" merge-switch":"";
+  return Key;
+}
+
+static bool writeHeatCFGToStore(const Function &F, const HeatProfile &HP,
+                                const HeatCFGOptions &Opts){
+  HeatLog Log;
+  std::string Filename = getHeatCFGFilename(F,Opts.OutputTag);
+  std::string Key =
+      HeatOutputStore::getFunctionKey(F, HP, getHeatCFGOptionsKey(Opts),
+                                      getHeatCFGMaxFreq(F,HP,Opts));
+  if (Opts.Store->link(Key,Filename)) {
+    Log << "Reusing '" << Filename << "'...\n";
+    return true;
+  }
+
+  Log << "Writing '" << Filename << "'...";
+  bool Stored = Opts.Store->store(Key, Filename, [&](raw_ostream &OS) {
+    writeHeatCFG(OS, F, HP, Opts);
+  });
+  if (!Stored)
+    Log << "  error writing to the output store!";
+  Log << "\n";
+  return Stored;
+}
+
+bool writeHeatCFGToDotFile(const Function &F, const HeatProfile &HP,
+                           const HeatCFGOptions &Opts){
+  // Near the memory budget, the labels are reduced to the block names and
+  // the file is written directly instead of being formatted into a buffer.
+  if (HeatMemoryBudget::instance().isNearLimit() &&
+      (!Opts.Simple || Opts.Writer)) {
+    HeatCFGOptions LowMemoryOpts = Opts;
+    LowMemoryOpts.Simple = true;
+    LowMemoryOpts.Writer = nullptr;
+    return writeHeatCFGToDotFile(F,HP,LowMemoryOpts);
+  }
+
+  if (Opts.PageSize && F.size()>Opts.PageSize) {
+    writeHeatCFGPages(F,HP,Opts);
+    return true;
+  }
+
+  if (Opts.Store)
+    return writeHeatCFGToStore(F,HP,Opts);
+
+  std::string Filename = getHeatCFGFilename(F,Opts.OutputTag);
+  if (Opts.Writer) {
+    HeatLog() << "Writing '" << Filename << "'...\n";
+    std::string Contents;
+    raw_string_ostream OS(Contents);
+    writeHeatCFG(OS, F, HP, Opts);
+    Opts.Writer->write(Filename, std::move(OS.str()));
+    return true;
+  }
+
+  return writeHeatReport(Filename,[&](raw_ostream &OS) {
+    writeHeatCFG(OS, F, HP, Opts);
+  });
+}
+
+void writeHeatCFGToDotFiles(const HeatProfile &HP,
+                            const HeatCFGOptions &Opts,
+                            HeatIndex *Index){
+  typedef std::chrono::steady_clock Clock;
+  bool HasDeadline = (Opts.Deadline!=Clock::time_point::max());
+
+  std::vector<unsigned> Order(HP.getNumFunctions());
+  for (unsigned FI = 0; FI<HP.getNumFunctions(); FI++)
+    Order[FI] = FI;
+  if (HasDeadline) {
+    ArrayRef<uint64_t> MaxFreqs = HP.functionMaxFreqs();
+    std::stable_sort(Order.begin(), Order.end(),
+                     [MaxFreqs](unsigned A, unsigned B) {
+                       return MaxFreqs[A]>MaxFreqs[B];
+                     });
+  }
+
+  for (unsigned i = 0; i<Order.size(); i++) {
+    if (HasDeadline && Clock::now()>=Opts.Deadline) {
+      unsigned NumSkipped = Order.size()-i;
+      HeatLog() << "Time budget exhausted, skipping the " << NumSkipped
+                << " coldest of " << Order.size() << " functions\n";
+      if (Index)
+        Index->NumSkipped += NumSkipped;
+      break;
+    }
+    unsigned FI = Order[i];
+    const Function &F = *HP.getFunction(FI);
+    if (!writeHeatCFGToDotFile(F,HP,Opts) || !Index)
+      continue;
+    HeatIndexEntry Entry;
+    Entry.MaxFreq = HP.getFunctionMaxFreq(FI);
+    Entry.Filename = getHeatCFGOutputFilename(F,Opts);
+    Entry.Function = F.getName().str();
+    Index->Entries.push_back(Entry);
+  }
+}
+
+}
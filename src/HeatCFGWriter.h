@@ -0,0 +1,98 @@
+//===-- HeatCFGWriter.h - Heat CFG dot writer -------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the functions that write the CFG of a function, coloured
+// with a heat map of the basic block frequencies of a HeatProfile, as a dot
+// graph.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATCFGWRITER_H
+#define LLVM_ANALYSIS_HEATCFGWRITER_H
+
+#include "HeatAsyncWriter.h"
+#include "HeatIndex.h"
+#include "HeatOutputStore.h"
+#include "HeatProfile.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <string>
+
+using namespace llvm;
+
+namespace llvm {
+
+struct HeatCFGOptions {
+  /// Scale the heat by the maximum frequency of the function instead of the
+  /// maximum frequency of the module.
+  bool PerFunction = false;
+  /// Label the edges with the raw branch weights from PGO.
+  bool RawEdgeWeight = false;
+  /// Do not label the edges.
+  bool NoEdgeWeight = false;
+  /// Print only the block names instead of their instructions.
+  bool Simple = false;
+  /// Draw the parallel edges of a switch to the same block as a single edge,
+  /// labelled with all their case values and their combined heat.
+  bool MergeSwitchEdges = false;
+  /// Split the CFGs with more blocks than this into pages (0 to disable).
+  unsigned PageSize = 0;
+  /// Maximum frequency of the module, overriding the one of the profile when
+  /// it is not 0, e.g. when the profile only has a shard of the module.
+  uint64_t MaxFreq = 0;
+  /// If set, the CFG files are reused from this store when their inputs did
+  /// not change, and added to it otherwise. Paginated CFGs are not stored.
+  HeatOutputStore *Store = nullptr;
+  /// If set, the CFG files are formatted on the calling thread and written
+  /// by this writer. Paginated and stored CFGs are written synchronously.
+  HeatAsyncWriter *Writer = nullptr;
+  /// If not empty, inserted in the names of the files, so that concurrent
+  /// instances of a module do not write to the same files.
+  std::string OutputTag;
+  /// If set, the functions are written from the hottest one, and the
+  /// remaining ones are skipped once this time is reached.
+  std::chrono::steady_clock::time_point Deadline =
+      std::chrono::steady_clock::time_point::max();
+};
+
+/// Returns heatcfg.<fnname>.dot, or heatcfg.<fnname>.<tag>.dot.
+std::string getHeatCFGFilename(const Function &F, StringRef Tag = "");
+
+/// Returns the file written for \p F, which is the index page when the CFG
+/// is paginated.
+std::string getHeatCFGOutputFilename(const Function &F,
+                                     const HeatCFGOptions &Opts);
+
+void writeHeatCFG(raw_ostream &OS, const Function &F, const HeatProfile &HP,
+                  const HeatCFGOptions &Opts);
+
+/// Writes the heat CFG of \p F split into pages of at most Opts.PageSize
+/// blocks, to heatcfg.<fnname>.page<N>.dot and heatcfg.<fnname>.index.dot.
+void writeHeatCFGPages(const Function &F, const HeatProfile &HP,
+                       const HeatCFGOptions &Opts);
+
+/// Writes the heat CFG of \p F to heatcfg.<fnname>.dot, or to pages if it
+/// has more blocks than Opts.PageSize. Near the memory budget, it is written
+/// with simple labels and without the asynchronous writer.
+bool writeHeatCFGToDotFile(const Function &F, const HeatProfile &HP,
+                           const HeatCFGOptions &Opts);
+
+/// Writes the heat CFG of every function in the profile, or of the hottest
+/// ones until Opts.Deadline, adding the files written and the number of
+/// functions skipped to \p Index if it is not null.
+void writeHeatCFGToDotFiles(const HeatProfile &HP,
+                            const HeatCFGOptions &Opts,
+                            HeatIndex *Index = nullptr);
+
+}
+
+#endif
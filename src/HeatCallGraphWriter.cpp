@@ -0,0 +1,271 @@
+
+#include "HeatCallGraphWriter.h"
+#include "HeatPagination.h"
+#include "HeatUtils.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Analysis/CallGraph.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/DOTGraphTraits.h"
+#include "llvm/Support/GraphWriter.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <set>
+#include <string>
+
+namespace llvm {
+
+class HeatCallGraphInfo {
+private:
+   CallGraph *CG;
+   const HeatProfile *HP;
+   const HeatCallGraphOptions *Opts;
+   DenseMap<const Function *, uint64_t> freq;
+   uint64_t maxFreq;
+public:
+   HeatCallGraphInfo(CallGraph *CG, const HeatProfile *HP,
+                     const HeatCallGraphOptions *Opts){
+     this->CG = CG;
+     this->HP = HP;
+     this->Opts = Opts;
+     maxFreq = 0;
+
+     for (unsigned FI = 0; FI<HP->getNumFunctions(); FI++) {
+       uint64_t localMaxFreq = Opts->UseCallCounter?
+                               HP->getFunctionEntryCount(FI):
+                               HP->getFunctionMaxFreq(FI);
+       if(localMaxFreq>=maxFreq) maxFreq = localMaxFreq;
+       freq[HP->getFunction(FI)] = localMaxFreq;
+     }
+     removeParallelEdges();
+   }
+
+   Module *getModule() const { return &HP->getModule(); }
+   CallGraph *getCallGraph() const { return CG; }
+   const HeatProfile *getProfile() const { return HP; }
+   const HeatCallGraphOptions &getOptions() const { return *Opts; }
+
+   uint64_t getFreq(const Function *F) { return freq.lookup(F); }
+
+   uint64_t getMaxFreq() { return maxFreq; }
+
+private:
+   void removeParallelEdges(){
+      for (auto &I : (*CG)) {
+         CallGraphNode *Node = I.second.get();
+         
+         bool foundParallelEdge = true;
+         while (foundParallelEdge) {
+            std::set<Function *> visited;
+            foundParallelEdge = false;
+            for (std::vector<CallGraphNode::CallRecord>::iterator CI =
+                 Node->begin(); CI!=Node->end(); CI++) {
+               if (visited.find(CI->second->getFunction())==visited.end())
+                  visited.insert(CI->second->getFunction());
+               else {
+                  foundParallelEdge = true;
+                  Node->removeCallEdge(CI);
+                  break;
+               }
+            }
+         }
+      }
+   }
+};
+
+
+template <>
+struct GraphTraits<HeatCallGraphInfo *> : public GraphTraits<
+                                            const CallGraphNode *> {
+  static NodeRef getEntryNode(HeatCallGraphInfo *HCG) {
+    // Start at the external node!
+    return HCG->getCallGraph()->getExternalCallingNode();
+  }
+
+  typedef std::pair<const Function *const, std::unique_ptr<CallGraphNode>>
+      PairTy;
+  static const CallGraphNode *CGGetValuePtr(const PairTy &P) {
+    return P.second.get();
+  }
+
+  // nodes_iterator/begin/end - Allow iteration over all nodes in the graph
+  typedef mapped_iterator<CallGraph::const_iterator, decltype(&CGGetValuePtr)>
+      nodes_iterator;
+
+  static nodes_iterator nodes_begin(HeatCallGraphInfo *HCG) {
+    return nodes_iterator(HCG->getCallGraph()->begin(), &CGGetValuePtr);
+  }
+  static nodes_iterator nodes_end(HeatCallGraphInfo *HCG) {
+    return nodes_iterator(HCG->getCallGraph()->end(), &CGGetValuePtr);
+  }
+};
+
+
+template<>
+struct DOTGraphTraits<HeatCallGraphInfo *> : public DefaultDOTGraphTraits {
+
+  DOTGraphTraits (bool isSimple=false) : DefaultDOTGraphTraits(isSimple) {}
+
+  // The graph is not passed to isNodeHidden, so it is recorded here, as the
+  // graph name is always requested before any node is written.
+  HeatCallGraphInfo *CurrentGraph = nullptr;
+
+  std::string getGraphName(HeatCallGraphInfo *Graph) {
+    CurrentGraph = Graph;
+    return "Call graph of module "+
+           std::string(Graph->getModule()->getModuleIdentifier());
+  }
+
+  bool isNodeHidden(const CallGraphNode *Node) {
+    if (CurrentGraph && CurrentGraph->getOptions().FullCallGraph)
+       return false;
+
+    if (Node->getFunction())
+       return false;
+
+    return true;
+  }
+
+  std::string getNodeLabel(const CallGraphNode *Node, HeatCallGraphInfo *Graph){
+
+    if (Node==Graph->getCallGraph()->getExternalCallingNode())
+       return "external caller";
+
+    if (Node==Graph->getCallGraph()->getCallsExternalNode())
+       return "external callee";
+
+    if (Function *Func = Node->getFunction())
+      return Func->getName();
+
+    return "external node";
+  }
+
+  static const CallGraphNode *CGGetValuePtr(CallGraphNode::CallRecord P) {
+    return P.second;
+  }
+
+  // nodes_iterator/begin/end - Allow iteration over all nodes in the graph
+  typedef mapped_iterator<CallGraphNode::const_iterator,
+                          decltype(&CGGetValuePtr)>
+      nodes_iterator;
+
+
+  std::string getEdgeAttributes(const CallGraphNode *Node, nodes_iterator I,
+                                HeatCallGraphInfo *Graph) {
+    if (!Graph->getOptions().EstimateEdgeWeight)
+       return "";
+
+    Function *F = Node->getFunction();
+    if (F==nullptr || F->isDeclaration())
+       return "";
+
+    Function *SuccFunction = (*I)->getFunction();
+    if (SuccFunction==nullptr)
+       return "";
+
+    uint64_t counter = Graph->getProfile()->getNumOfCalls(F, SuccFunction);
+    std::string Attrs = "label=\"" + std::to_string(counter) + "\"";
+    return Attrs;
+  }
+
+  std::string getNodeAttributes(const CallGraphNode *Node,
+                                HeatCallGraphInfo *Graph) {
+    Function *F = Node->getFunction();
+    if (F==nullptr || F->isDeclaration())
+       return "";
+
+    uint64_t freq = Graph->getFreq(F);
+    std::string color = getHeatColor(freq, Graph->getMaxFreq());
+    std::string edgeColor = (freq<(Graph->getMaxFreq()/2))?
+                            getHeatColor(0):getHeatColor(1);
+
+    std::string attrs = "color=\"" + edgeColor +
+                        "ff\", style=filled, fillcolor=\"" + color + "80\"";
+
+    return attrs;
+  }
+
+};
+
+std::string getHeatCallGraphFilename(const Module &M, StringRef Tag){
+  return getHeatOutputFilename(M.getModuleIdentifier(),Tag,
+                               ".heatcallgraph.dot");
+}
+
+void writeHeatCallGraph(raw_ostream &OS, const HeatProfile &HP,
+                        const HeatCallGraphOptions &Opts){
+  CallGraph CG(HP.getModule());
+  HeatCallGraphInfo heatCallGraphInfo(&CG,&HP,&Opts);
+  WriteGraph(OS, &heatCallGraphInfo);
+}
+
+void writeHeatCallGraphPages(const HeatProfile &HP,
+                             const HeatCallGraphOptions &Opts){
+  typedef DOTGraphTraits<HeatCallGraphInfo *> DOTTraits;
+
+  CallGraph CG(HP.getModule());
+  HeatCallGraphInfo heatCallGraphInfo(&CG,&HP,&Opts);
+  DOTTraits DTraits;
+
+  HeatPageGraph G;
+  G.Title = DTraits.getGraphName(&heatCallGraphInfo);
+  G.MaxFreq = heatCallGraphInfo.getMaxFreq();
+
+  DenseMap<const CallGraphNode *, unsigned> NodeIndex;
+  for (auto &I : CG) {
+    const CallGraphNode *Node = I.second.get();
+    if (DTraits.isNodeHidden(Node))
+      continue;
+    NodeIndex[Node] = G.Nodes.size();
+    HeatPageGraph::Node PageNode;
+    PageNode.Name = DTraits.getNodeLabel(Node,&heatCallGraphInfo);
+    PageNode.Label = PageNode.Name;
+    PageNode.Attrs = DTraits.getNodeAttributes(Node,&heatCallGraphInfo);
+    PageNode.Freq = heatCallGraphInfo.getFreq(Node->getFunction());
+    G.Nodes.push_back(PageNode);
+  }
+
+  for (auto &I : CG) {
+    const CallGraphNode *Node = I.second.get();
+    auto Src = NodeIndex.find(Node);
+    if (Src==NodeIndex.end())
+      continue;
+    for (CallGraphNode::const_iterator CI = Node->begin(), CE = Node->end();
+         CI!=CE; ++CI) {
+      auto Dst = NodeIndex.find(CI->second);
+      if (Dst==NodeIndex.end())
+        continue;
+      HeatPageGraph::Edge Edge;
+      Edge.Src = Src->second;
+      Edge.Dst = Dst->second;
+      Edge.Freq = HP.getNumOfCalls(Node->getFunction(),
+                                   CI->second->getFunction());
+      Edge.Attrs = DTraits.getEdgeAttributes(Node,
+          DOTTraits::nodes_iterator(CI,&DOTTraits::CGGetValuePtr),
+          &heatCallGraphInfo);
+      G.Edges.push_back(Edge);
+    }
+  }
+
+  writeHeatGraphPages(G,Opts.PageSize,
+                      getHeatOutputFilename(
+                          HP.getModule().getModuleIdentifier(),
+                          Opts.OutputTag,".heatcallgraph"));
+}
+
+bool writeHeatCallGraphToDotFile(const HeatProfile &HP,
+                                 const HeatCallGraphOptions &Opts){
+  if (Opts.PageSize && HP.getNumFunctions()>Opts.PageSize) {
+    writeHeatCallGraphPages(HP,Opts);
+    return true;
+  }
+
+  std::string Filename = getHeatCallGraphFilename(HP.getModule(),
+                                                  Opts.OutputTag);
+  return writeHeatReport(Filename,[&](raw_ostream &OS) {
+    writeHeatCallGraph(OS, HP, Opts);
+  });
+}
+
+}
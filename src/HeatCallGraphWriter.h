@@ -0,0 +1,65 @@
+//===-- HeatCallGraphWriter.h - Heat call graph dot writer ------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the functions that write the call graph of a module,
+// coloured with a heat map of the function frequencies of a HeatProfile, as a
+// dot graph.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATCALLGRAPHWRITER_H
+#define LLVM_ANALYSIS_HEATCALLGRAPHWRITER_H
+
+#include "HeatProfile.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+
+using namespace llvm;
+
+namespace llvm {
+
+struct HeatCallGraphOptions {
+  /// Label the edges with the number of calls.
+  bool EstimateEdgeWeight = false;
+  /// Print the external nodes of the call graph.
+  bool FullCallGraph = false;
+  /// Use the entry counts of the functions as their heat instead of their
+  /// maximum block frequencies.
+  bool UseCallCounter = false;
+  /// Split the call graph into pages of at most this many functions when it
+  /// has more (0 to disable).
+  unsigned PageSize = 0;
+  /// If not empty, inserted in the names of the files, so that concurrent
+  /// instances of a module do not write to the same files.
+  std::string OutputTag;
+};
+
+/// Returns <module>.heatcallgraph.dot, or <module>.<tag>.heatcallgraph.dot.
+std::string getHeatCallGraphFilename(const Module &M, StringRef Tag = "");
+
+void writeHeatCallGraph(raw_ostream &OS, const HeatProfile &HP,
+                        const HeatCallGraphOptions &Opts);
+
+/// Writes the heat call graph split into pages of at most Opts.PageSize
+/// functions, to <module>.heatcallgraph.page<N>.dot and
+/// <module>.heatcallgraph.index.dot.
+void writeHeatCallGraphPages(const HeatProfile &HP,
+                             const HeatCallGraphOptions &Opts);
+
+/// Writes the heat call graph to <module>.heatcallgraph.dot, or to pages if
+/// it has more functions than Opts.PageSize.
+bool writeHeatCallGraphToDotFile(const HeatProfile &HP,
+                                 const HeatCallGraphOptions &Opts);
+
+}
+
+#endif
@@ -1,4 +1,4 @@
-//===-- HeatCallPrinter.h - CFG printer external interface ------*- C++ -*-===//
+//===-- HeatCallPrinter.h - Call graph printer interface --------*- C++ -*-===//
 //
 //                     The LLVM Compiler Infrastructure
 //
@@ -7,34 +7,25 @@
 //
 //===----------------------------------------------------------------------===//
 //
-// This file defines a 'dot-heat-cfg' analysis pass, which emits the
-// cfg.<fnname>.dot file for each function in the program, with a graph of the
-// CFG for that function coloured with heat map depending on the basic block
-// frequency.
+// This file defines a 'dot-heat-callgraph' analysis pass, which emits the
+// callgraph.dot file of the module, with the functions coloured with heat map
+// depending on their maximum block frequency.
 //
-// This file defines external functions that can be called to explicitly
-// instantiate the CFG printer.
+// The pass is defined in HeatCallPrinterPass.h, with the function that can be
+// called to explicitly instantiate it. This file declares how its options are
+// taken from the command line.
 //
 //===----------------------------------------------------------------------===//
 
 #ifndef LLVM_ANALYSIS_HEATCALLPRINTER_H
 #define LLVM_ANALYSIS_HEATCALLPRINTER_H
 
-#include "llvm/IR/Module.h"
-#include "llvm/Pass.h"
+#include "HeatCallPrinterPass.h"
 
-using namespace llvm;
+namespace llvm {
 
-namespace {
-
-class HeatCallGraphDOTPrinterPass : public ModulePass {
-public:
-  static char ID;
-  HeatCallGraphDOTPrinterPass() : ModulePass(ID) {}
-
-  void getAnalysisUsage(AnalysisUsage &AU) const;
-  bool runOnModule(Module &M) override;
-};
+/// Returns the options given on the command line.
+HeatCallGraphPrinterOptions getHeatCallGraphPrinterOptions();
 
 }
 
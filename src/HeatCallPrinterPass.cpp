@@ -0,0 +1,32 @@
+
+#include "HeatCallPrinterPass.h"
+#include "HeatCallGraphWriter.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace llvm {
+
+char HeatCallGraphDOTPrinterPass::ID = 0;
+
+bool HeatCallGraphDOTPrinterPass::runOnModule(Module &M) {
+  HeatCallGraphOptions RunOpts = Opts.CallGraph;
+  if (Opts.UniqueOutput)
+    RunOpts.OutputTag = getUniqueHeatOutputTag();
+
+  HeatProfile &HP = getHeatProfile(M,Opts.Profile);
+  writeHeatCallGraphToDotFile(HP,RunOpts);
+
+  return false;
+}
+
+ModulePass *
+createHeatCallGraphPrinterPass(const HeatCallGraphPrinterOptions &Opts){
+  return new HeatCallGraphDOTPrinterPass(Opts);
+}
+
+}
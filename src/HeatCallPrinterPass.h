@@ -0,0 +1,61 @@
+//===-- HeatCallPrinterPass.h - Heat call graph printer pass ----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the 'dot-heat-callgraph' pass, which emits the
+// callgraph.dot file of the module, and the function creating it with its
+// own options.
+//
+// The pass is part of the core library, so that tools can create it. Its
+// default constructor takes the options from the command line, and is only
+// defined in the HeatPrinter plugin, which registers the pass.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATCALLPRINTERPASS_H
+#define LLVM_ANALYSIS_HEATCALLPRINTERPASS_H
+
+#include "HeatCallGraphWriter.h"
+#include "HeatProfile.h"
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace llvm {
+
+/// Options of the heat call graph printer, taken from the command line or
+/// given to createHeatCallGraphPrinterPass.
+struct HeatCallGraphPrinterOptions {
+  HeatCallGraphOptions CallGraph;
+  HeatProfileOptions Profile;
+  /// Insert a unique tag in the names of the files written for each module.
+  bool UniqueOutput = false;
+};
+
+ModulePass *
+createHeatCallGraphPrinterPass(const HeatCallGraphPrinterOptions &Opts);
+
+class HeatCallGraphDOTPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatCallGraphDOTPrinterPass();
+  explicit HeatCallGraphDOTPrinterPass(const HeatCallGraphPrinterOptions &Opts)
+      : HeatReportPass(ID), Opts(Opts) {}
+
+  bool runOnModule(Module &M) override;
+
+private:
+  HeatCallGraphPrinterOptions Opts;
+};
+
+}
+
+#endif
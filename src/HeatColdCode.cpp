@@ -0,0 +1,170 @@
+
+#include "HeatColdCode.h"
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/ModuleSlotTracker.h"
+#include "llvm/Support/Format.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace llvm {
+
+static unsigned getBlockSize(const BasicBlock &BB){
+  unsigned Size = 0;
+  for (const Instruction &I : BB)
+    if (!isa<DbgInfoIntrinsic>(I))
+      Size++;
+  return Size;
+}
+
+static unsigned findRoot(std::vector<unsigned> &Parent, unsigned N){
+  while (Parent[N]!=N)
+    N = Parent[N] = Parent[Parent[N]];
+  return N;
+}
+
+HeatColdCode HeatColdCode::get(const HeatProfile &HP, unsigned MinRegionSize){
+  HeatColdCode Cold;
+  Cold.FunctionSize.resize(HP.getNumFunctions(),0);
+  std::vector<unsigned> BlockSize;
+  std::vector<unsigned> Parent;
+  for (unsigned FI = 0; FI<HP.getNumFunctions(); FI++) {
+    ArrayRef<const BasicBlock *> Blocks = HP.blocks(FI);
+    ArrayRef<uint64_t> Freqs = HP.blockFreqs(FI);
+    unsigned FirstBI = HP.getFirstBlock(FI);
+
+    BlockSize.resize(Blocks.size());
+    for (unsigned i = 0; i<Blocks.size(); i++) {
+      BlockSize[i] = getBlockSize(*Blocks[i]);
+      Cold.FunctionSize[FI] += BlockSize[i];
+    }
+    Cold.TotalSize += Cold.FunctionSize[FI];
+
+    // A function is only known to be never executed from its entry count,
+    // as block frequencies are also 0 without profile data for it.
+    Optional<uint64_t> EntryCount = HP.getFunction(FI)->getEntryCount();
+    if (!EntryCount)
+      continue;
+    Cold.NumCounted++;
+    if (*EntryCount==0) {
+      Cold.ColdFunctions.push_back(FI);
+      Cold.ColdFunctionSize += Cold.FunctionSize[FI];
+      continue;
+    }
+
+    // Never executed blocks are merged with their never executed successors
+    // into regions.
+    Parent.resize(Blocks.size());
+    std::iota(Parent.begin(), Parent.end(), 0);
+    for (unsigned i = 0; i<Blocks.size(); i++) {
+      if (Freqs[i])
+        continue;
+      for (const BasicBlock *Succ : successors(Blocks[i])) {
+        unsigned j = HP.getBlockIndex(Succ)-FirstBI;
+        if (Freqs[j]==0)
+          Parent[findRoot(Parent,i)] = findRoot(Parent,j);
+      }
+    }
+
+    unsigned FirstRegion = Cold.Regions.size();
+    std::vector<unsigned> RegionOfRoot(Blocks.size(),~0u);
+    for (unsigned i = 0; i<Blocks.size(); i++) {
+      if (Freqs[i])
+        continue;
+      unsigned Root = findRoot(Parent,i);
+      if (RegionOfRoot[Root]==~0u) {
+        RegionOfRoot[Root] = Cold.Regions.size();
+        HeatColdRegion Region;
+        Region.Function = FI;
+        Region.Size = 0;
+        Cold.Regions.push_back(Region);
+      }
+      HeatColdRegion &Region = Cold.Regions[RegionOfRoot[Root]];
+      Region.Blocks.push_back(Blocks[i]);
+      Region.Size += BlockSize[i];
+    }
+    Cold.Regions.erase(std::remove_if(Cold.Regions.begin()+FirstRegion,
+                                      Cold.Regions.end(),
+                                      [MinRegionSize](const HeatColdRegion &R) {
+                                        return R.Size<MinRegionSize;
+                                      }),
+                       Cold.Regions.end());
+  }
+
+  for (const HeatColdRegion &Region : Cold.Regions)
+    Cold.ColdRegionSize += Region.Size;
+  std::stable_sort(Cold.ColdFunctions.begin(), Cold.ColdFunctions.end(),
+                   [&Cold](unsigned A, unsigned B) {
+                     return Cold.FunctionSize[A]>Cold.FunctionSize[B];
+                   });
+  std::stable_sort(Cold.Regions.begin(), Cold.Regions.end(),
+                   [](const HeatColdRegion &A, const HeatColdRegion &B) {
+                     return A.Size>B.Size;
+                   });
+  return Cold;
+}
+
+static double getPercent(unsigned Size, unsigned Total){
+  return Total?100.0*Size/Total:0.0;
+}
+
+void HeatColdCode::print(raw_ostream &OS, const HeatProfile &HP,
+                         unsigned MaxEntries) const {
+  OS << "Instructions: " << TotalSize << "\n";
+  OS << "Functions with an entry count: " << NumCounted << " of "
+     << HP.getNumFunctions() << "\n";
+  OS << "Never executed functions: " << ColdFunctions.size() << " of "
+     << NumCounted << ", " << ColdFunctionSize << " instructions ("
+     << format("%.1f%%", getPercent(ColdFunctionSize,TotalSize)) << ")\n";
+  OS << "Never executed regions: " << Regions.size() << ", "
+     << ColdRegionSize << " instructions ("
+     << format("%.1f%%", getPercent(ColdRegionSize,TotalSize)) << ")\n";
+
+  OS << "\n# Never executed functions\n";
+  OS << "# size function\n";
+  for (unsigned i = 0; i<ColdFunctions.size() && i<MaxEntries; i++) {
+    unsigned FI = ColdFunctions[i];
+    OS << FunctionSize[FI] << " " << HP.getFunction(FI)->getName() << "\n";
+  }
+
+  OS << "\n# Never executed regions\n";
+  OS << "# size share-of-function function blocks\n";
+  ModuleSlotTracker MST(&HP.getModule(), false);
+  for (unsigned i = 0; i<Regions.size() && i<MaxEntries; i++) {
+    const HeatColdRegion &Region = Regions[i];
+    const Function *F = HP.getFunction(Region.Function);
+    if (MST.getCurrentFunction()!=F)
+      MST.incorporateFunction(*F);
+    OS << Region.Size << " "
+       << format("%.1f%%", getPercent(Region.Size,
+                                      FunctionSize[Region.Function]))
+       << " " << F->getName() << " ";
+    for (unsigned j = 0; j<Region.Blocks.size(); j++) {
+      if (j)
+        OS << ",";
+      Region.Blocks[j]->printAsOperand(OS,false,MST);
+    }
+    OS << "\n";
+  }
+}
+
+void writeHeatCoverageBitmap(raw_ostream &OS, const HeatProfile &HP){
+  for (unsigned FI = 0; FI<HP.getNumFunctions(); FI++) {
+    ArrayRef<uint64_t> Freqs = HP.blockFreqs(FI);
+    OS << HP.getFunction(FI)->getName() << " " << Freqs.size() << " ";
+    for (unsigned i = 0; i<Freqs.size(); i += 4) {
+      unsigned Digit = 0;
+      for (unsigned j = 0; j<4 && i+j<Freqs.size(); j++)
+        if (Freqs[i+j])
+          Digit |= 1u << j;
+      OS << hexdigit(Digit,/*LowerCase=*/true);
+    }
+    OS << "\n";
+  }
+}
+
+}
@@ -0,0 +1,80 @@
+//===-- HeatColdCode.h - Never executed code --------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the report of the code that a profile shows never
+// executed: the functions with an entry count of 0, and the regions of
+// connected never executed blocks in the other functions, with their size,
+// as candidates to be moved to cold sections or removed. Functions without
+// an entry count are left out, as nothing is known about them.
+//
+// It also defines the coverage bitmap of a module, with one bit per block,
+// whose text form is compact and can be diffed line by line between runs.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATCOLDCODE_H
+#define LLVM_ANALYSIS_HEATCOLDCODE_H
+
+#include "HeatProfile.h"
+
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+/// Blocks of a function that are never executed and connected by CFG edges.
+struct HeatColdRegion {
+  /// Index of the function in the profile.
+  unsigned Function;
+  /// Blocks of the region, in function order.
+  std::vector<const BasicBlock *> Blocks;
+  unsigned Size;
+};
+
+struct HeatColdCode {
+  /// Number of instructions per function, indexed by function index.
+  /// Debug intrinsics are not counted, as they generate no code.
+  std::vector<unsigned> FunctionSize;
+  /// Never executed functions, by decreasing size.
+  std::vector<unsigned> ColdFunctions;
+  /// Number of functions with an entry count, the only ones reported on.
+  unsigned NumCounted = 0;
+  /// Never executed regions of executed functions with at least the minimum
+  /// size, by decreasing size.
+  std::vector<HeatColdRegion> Regions;
+  unsigned TotalSize = 0;
+  unsigned ColdFunctionSize = 0;
+  unsigned ColdRegionSize = 0;
+
+  /// Finds the never executed code of \p HP, keeping the regions of at
+  /// least \p MinRegionSize instructions.
+  static HeatColdCode get(const HeatProfile &HP, unsigned MinRegionSize);
+
+  /// Returns true if some function has an entry count, without which the
+  /// report is meaningless.
+  bool hasEntryCounts() const { return NumCounted!=0; }
+
+  /// Prints the totals, the never executed functions and the regions, at
+  /// most \p MaxEntries of each.
+  void print(raw_ostream &OS, const HeatProfile &HP,
+             unsigned MaxEntries) const;
+};
+
+/// Writes the coverage bitmap of \p HP, one line per function with its name,
+/// its number of blocks and, in hexadecimal, one bit per block set if the
+/// block is executed. Block 4*i+j is bit j of the i-th digit.
+void writeHeatCoverageBitmap(raw_ostream &OS, const HeatProfile &HP);
+
+}
+
+#endif
@@ -0,0 +1,76 @@
+//===-- HeatColdPrinter.cpp - Never executed code printer -------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-cold-code' analysis pass, which emits the
+// <module>.heatcold.txt report of the functions and the large regions of
+// blocks that the profile shows never executed, with their size, and the
+// <module>.heatcoverage.txt coverage bitmap of the blocks.
+//===----------------------------------------------------------------------===//
+
+#include "HeatColdPrinter.h"
+#include "HeatColdCode.h"
+#include "HeatPrinterOptions.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+
+using namespace llvm;
+
+
+static cl::opt<unsigned>
+ColdMinSize("heat-cold-min-size", cl::init(16), cl::Hidden,
+            cl::desc("Minimum number of instructions of the reported never "
+                     "executed regions"));
+
+static cl::opt<unsigned>
+ColdEntries("heat-cold-entries", cl::init(100), cl::Hidden,
+            cl::desc("Number of largest never executed functions and "
+                     "regions reported"));
+
+namespace {
+
+bool HeatColdPrinterPass::runOnModule(Module &M) {
+  HeatLog Log;
+  HeatProfile &HP = getHeatProfile(M,getHeatProfileOptions());
+  HeatColdCode Cold = HeatColdCode::get(HP,ColdMinSize);
+  // Branch weights alone, e.g. from __builtin_expect, tell nothing about the
+  // code that is never executed.
+  if (!Cold.hasEntryCounts()) {
+    Log << "error: '" << M.getModuleIdentifier() << "' has no entry counts, "
+        << "no code is known to be never executed\n";
+    return false;
+  }
+
+  std::string Tag = getHeatOutputTag();
+  std::string Filename = getHeatOutputFilename(M.getModuleIdentifier(),Tag,
+                                               ".heatcold.txt");
+  writeHeatReport(Filename,[&](raw_ostream &OS) {
+    Cold.print(OS,HP,ColdEntries);
+  });
+
+  Filename = getHeatOutputFilename(M.getModuleIdentifier(),Tag,
+                                   ".heatcoverage.txt");
+  writeHeatReport(Filename,[&](raw_ostream &OS) {
+    writeHeatCoverageBitmap(OS,HP);
+  });
+  return false;
+}
+
+}
+
+char HeatColdPrinterPass::ID = 0;
+static RegisterPass<HeatColdPrinterPass> X("heat-cold-code",
+          "Print the never executed code and the block coverage bitmap.",
+          false, false);
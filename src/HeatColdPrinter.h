@@ -0,0 +1,38 @@
+//===-- HeatColdPrinter.h - Never executed code printer ---------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-cold-code' analysis pass, which emits the
+// <module>.heatcold.txt report of the never executed code and the
+// <module>.heatcoverage.txt coverage bitmap.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATCOLDPRINTER_H
+#define LLVM_ANALYSIS_HEATCOLDPRINTER_H
+
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace {
+
+class HeatColdPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatColdPrinterPass() : HeatReportPass(ID) {}
+
+  bool runOnModule(Module &M) override;
+};
+
+}
+
+#endif
@@ -0,0 +1,178 @@
+
+#include "HeatCommunity.h"
+
+#include <algorithm>
+
+namespace llvm {
+
+std::vector<unsigned> detectHeatCommunities(unsigned NumNodes,
+                                            ArrayRef<uint64_t> NodeHeat,
+                                            ArrayRef<HeatCommunityEdge> Edges,
+                                            unsigned MaxIterations){
+  // Undirected adjacency lists in compressed form, without self loops. Cold
+  // edges get a unit weight, so that callers and callees still attract.
+  std::vector<unsigned> AdjBegin(NumNodes+1,0);
+  for (const HeatCommunityEdge &E : Edges) {
+    if (E.Src==E.Dst)
+      continue;
+    AdjBegin[E.Src+1]++;
+    AdjBegin[E.Dst+1]++;
+  }
+  for (unsigned N = 0; N<NumNodes; N++)
+    AdjBegin[N+1] += AdjBegin[N];
+  std::vector<std::pair<unsigned, uint64_t>> Adj(AdjBegin[NumNodes]);
+  std::vector<unsigned> AdjEnd(AdjBegin.begin(), AdjBegin.end()-1);
+  for (const HeatCommunityEdge &E : Edges) {
+    if (E.Src==E.Dst)
+      continue;
+    Adj[AdjEnd[E.Src]++] = std::make_pair(E.Dst,E.Weight+1);
+    Adj[AdjEnd[E.Dst]++] = std::make_pair(E.Src,E.Weight+1);
+  }
+
+  std::vector<unsigned> Order(NumNodes);
+  for (unsigned N = 0; N<NumNodes; N++)
+    Order[N] = N;
+  std::stable_sort(Order.begin(), Order.end(), [&](unsigned A, unsigned B) {
+    return NodeHeat[A]>NodeHeat[B];
+  });
+
+  std::vector<unsigned> Label(NumNodes);
+  for (unsigned N = 0; N<NumNodes; N++)
+    Label[N] = N;
+
+  // Labels are updated in place, which avoids the oscillations of the
+  // synchronous variant. A node keeps its label on ties.
+  std::vector<uint64_t> LabelWeight(NumNodes,0);
+  std::vector<unsigned> Touched;
+  for (unsigned It = 0; It<MaxIterations; It++) {
+    unsigned Changed = 0;
+    for (unsigned N : Order) {
+      for (unsigned i = AdjBegin[N]; i<AdjBegin[N+1]; i++) {
+        unsigned L = Label[Adj[i].first];
+        if (LabelWeight[L]==0)
+          Touched.push_back(L);
+        LabelWeight[L] += Adj[i].second;
+      }
+      unsigned Best = Label[N];
+      uint64_t BestWeight = LabelWeight[Best];
+      for (unsigned L : Touched) {
+        if (LabelWeight[L]>BestWeight) {
+          Best = L;
+          BestWeight = LabelWeight[L];
+        }
+        LabelWeight[L] = 0;
+      }
+      Touched.clear();
+      if (Best!=Label[N]) {
+        Label[N] = Best;
+        Changed++;
+      }
+    }
+    if (Changed==0)
+      break;
+  }
+
+  // Number the communities densely, in order of their first node.
+  std::vector<unsigned> Dense(NumNodes,~0u);
+  unsigned NumCommunities = 0;
+  for (unsigned N = 0; N<NumNodes; N++) {
+    if (Dense[Label[N]]==~0u)
+      Dense[Label[N]] = NumCommunities++;
+    Label[N] = Dense[Label[N]];
+  }
+  return Label;
+}
+
+std::vector<HeatCommunityLevel>
+buildHeatCommunityHierarchy(const HeatProfile &HP, unsigned MaxLevels,
+                            unsigned MaxIterations){
+  // Nodes of the current level.
+  unsigned NumNodes = HP.getNumFunctions();
+  std::vector<uint64_t> NodeHeat(HP.functionMaxFreqs().begin(),
+                                 HP.functionMaxFreqs().end());
+  std::vector<unsigned> NodeFunctions(NumNodes,1);
+  std::vector<unsigned> NodeHottest(NumNodes);
+  std::vector<uint64_t> NodeInternal(NumNodes,0);
+  for (unsigned N = 0; N<NumNodes; N++)
+    NodeHottest[N] = N;
+
+  std::vector<HeatCommunityEdge> Edges;
+  for (const HeatCallSite &CS : HP.callSites()) {
+    int Callee = HP.getFunctionIndex(CS.Callee);
+    if (Callee<0)
+      continue;
+    HeatCommunityEdge E;
+    E.Src = CS.Caller;
+    E.Dst = Callee;
+    E.Weight = CS.Freq;
+    Edges.push_back(E);
+  }
+
+  std::vector<HeatCommunityLevel> Levels;
+  while (Levels.size()<MaxLevels && NumNodes>0) {
+    Levels.emplace_back();
+    HeatCommunityLevel &Level = Levels.back();
+    Level.Community = detectHeatCommunities(NumNodes,NodeHeat,Edges,
+                                            MaxIterations);
+    unsigned K = 0;
+    for (unsigned C : Level.Community)
+      K = std::max(K,C+1);
+    Level.NumCommunities = K;
+
+    Level.MaxFreq.assign(K,0);
+    Level.NumFunctions.assign(K,0);
+    Level.Hottest.assign(K,0);
+    Level.InternalCalls.assign(K,0);
+    std::vector<bool> HasHottest(K,false);
+    for (unsigned N = 0; N<NumNodes; N++) {
+      unsigned C = Level.Community[N];
+      Level.NumFunctions[C] += NodeFunctions[N];
+      Level.InternalCalls[C] += NodeInternal[N];
+      if (!HasHottest[C] || NodeHeat[N]>Level.MaxFreq[C]) {
+        Level.MaxFreq[C] = NodeHeat[N];
+        Level.Hottest[C] = NodeHottest[N];
+        HasHottest[C] = true;
+      }
+    }
+
+    // Contract the edges, merging the parallel ones.
+    std::vector<HeatCommunityEdge> Contracted;
+    for (const HeatCommunityEdge &E : Edges) {
+      unsigned Src = Level.Community[E.Src];
+      unsigned Dst = Level.Community[E.Dst];
+      if (Src==Dst) {
+        Level.InternalCalls[Src] += E.Weight;
+        continue;
+      }
+      HeatCommunityEdge CE;
+      CE.Src = Src;
+      CE.Dst = Dst;
+      CE.Weight = E.Weight;
+      Contracted.push_back(CE);
+    }
+    std::sort(Contracted.begin(), Contracted.end(),
+              [](const HeatCommunityEdge &A, const HeatCommunityEdge &B) {
+                return std::make_pair(A.Src,A.Dst)<std::make_pair(B.Src,B.Dst);
+              });
+    for (const HeatCommunityEdge &E : Contracted) {
+      if (!Level.Edges.empty() && Level.Edges.back().Src==E.Src &&
+          Level.Edges.back().Dst==E.Dst)
+        Level.Edges.back().Weight += E.Weight;
+      else
+        Level.Edges.push_back(E);
+    }
+
+    if (K==NumNodes || K==1)
+      break;
+
+    NumNodes = K;
+    NodeHeat = Level.MaxFreq;
+    NodeFunctions = Level.NumFunctions;
+    NodeHottest = Level.Hottest;
+    NodeInternal = Level.InternalCalls;
+    Edges = Level.Edges;
+  }
+  return Levels;
+}
+
+}
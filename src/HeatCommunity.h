@@ -0,0 +1,73 @@
+//===-- HeatCommunity.h - Communities of the heat call graph ----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the detection of communities in the heat call graph,
+// used to summarize whole-program call graphs.
+//
+// Communities are found by label propagation weighted by the number of
+// calls, which is linear in the number of call edges per iteration. The
+// communities are then contracted into nodes and the detection is repeated,
+// building a hierarchy whose last level is the most summarized one.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATCOMMUNITY_H
+#define LLVM_ANALYSIS_HEATCOMMUNITY_H
+
+#include "HeatProfile.h"
+
+#include "llvm/ADT/ArrayRef.h"
+
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+struct HeatCommunityEdge {
+  unsigned Src;
+  unsigned Dst;
+  uint64_t Weight;
+};
+
+/// Assigns a community to each node, numbered densely from 0. Nodes are
+/// visited from the hottest one, and each takes the community with the
+/// largest total edge weight among its neighbours.
+std::vector<unsigned> detectHeatCommunities(unsigned NumNodes,
+                                            ArrayRef<uint64_t> NodeHeat,
+                                            ArrayRef<HeatCommunityEdge> Edges,
+                                            unsigned MaxIterations);
+
+/// One level of the community hierarchy. The nodes of level 0 are the
+/// functions of the profile, and the nodes of level L+1 are the communities
+/// of level L.
+struct HeatCommunityLevel {
+  /// Community of each node of this level.
+  std::vector<unsigned> Community;
+  unsigned NumCommunities = 0;
+  /// Per community: maximum frequency, number of functions, hottest
+  /// function (as a function index of the profile) and the number of calls
+  /// between its own functions.
+  std::vector<uint64_t> MaxFreq;
+  std::vector<unsigned> NumFunctions;
+  std::vector<unsigned> Hottest;
+  std::vector<uint64_t> InternalCalls;
+  /// Calls between different communities, one edge per pair.
+  std::vector<HeatCommunityEdge> Edges;
+};
+
+/// Builds the community hierarchy of the call graph of \p HP, stopping when
+/// a level does not merge any communities or after \p MaxLevels levels.
+std::vector<HeatCommunityLevel>
+buildHeatCommunityHierarchy(const HeatProfile &HP, unsigned MaxLevels,
+                            unsigned MaxIterations);
+
+}
+
+#endif
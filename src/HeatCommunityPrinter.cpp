@@ -0,0 +1,115 @@
+//===-- HeatCommunityPrinter.cpp - Call graph community printer -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'dot-heat-communities' analysis pass, which summarizes
+// the heat call graph of the module as a hierarchy of communities of
+// functions that call each other frequently.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeatCommunityPrinter.h"
+#include "HeatCommunity.h"
+#include "HeatPrinterOptions.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/GraphWriter.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+
+static cl::opt<unsigned>
+CommunityLevels("heat-community-levels", cl::init(4), cl::Hidden,
+                cl::desc("Maximum number of levels of communities"));
+
+static cl::opt<unsigned>
+CommunityIterations("heat-community-iterations", cl::init(20), cl::Hidden,
+                    cl::desc("Maximum label propagation iterations per level"));
+
+static void printCommunityLevel(raw_ostream &File, const HeatProfile &HP,
+                                const HeatCommunityLevel &Level, unsigned L){
+  std::string Title = "Call graph communities of module " +
+                      std::string(HP.getModule().getModuleIdentifier()) +
+                      " (level " + std::to_string(L) + ")";
+  File << "digraph \"" << DOT::EscapeString(Title) << "\" {\n";
+  File << "\tlabel=\"" << DOT::EscapeString(Title) << "\";\n\n";
+
+  uint64_t maxFreq = HP.getMaxFreq();
+  for (unsigned C = 0; C<Level.NumCommunities; C++) {
+    uint64_t freq = Level.MaxFreq[C];
+    std::string Label = HP.getFunction(Level.Hottest[C])->getName().str();
+    if (Level.NumFunctions[C]>1)
+      Label += " (+" + std::to_string(Level.NumFunctions[C]-1) + ")";
+    Label += "\nmax freq " + std::to_string(freq) +
+             "\ninternal calls " + std::to_string(Level.InternalCalls[C]);
+
+    std::string color = getHeatColor(freq, maxFreq);
+    std::string edgeColor = (freq<=(maxFreq/2))?
+                            (getHeatColor(0)):(getHeatColor(1));
+    File << "\tc" << C << " [shape=box,label=\"" << DOT::EscapeString(Label)
+         << "\",color=\"" << edgeColor << "ff\", style=filled, fillcolor=\""
+         << color << "80\"];\n";
+  }
+
+  for (const HeatCommunityEdge &E : Level.Edges)
+    File << "\tc" << E.Src << " -> c" << E.Dst << "[label=\"" << E.Weight
+         << "\"];\n";
+  File << "}\n";
+}
+
+static void printCommunityMembership(raw_ostream &File,
+                                     const HeatProfile &HP,
+                                     ArrayRef<HeatCommunityLevel> Levels){
+  File << "# function max-freq community-per-level\n";
+  for (unsigned FI = 0; FI<HP.getNumFunctions(); FI++) {
+    File << HP.getFunction(FI)->getName() << " "
+         << HP.getFunctionMaxFreq(FI);
+    unsigned Node = FI;
+    for (const HeatCommunityLevel &Level : Levels) {
+      Node = Level.Community[Node];
+      File << " " << Node;
+    }
+    File << "\n";
+  }
+}
+
+namespace {
+
+bool HeatCommunityPrinterPass::runOnModule(Module &M) {
+  HeatProfile &HP = getHeatProfile(M,getHeatProfileOptions());
+  std::vector<HeatCommunityLevel> Levels =
+      buildHeatCommunityHierarchy(HP,CommunityLevels,CommunityIterations);
+
+  std::string Prefix = getHeatOutputFilename(M.getModuleIdentifier(),
+                                             getHeatOutputTag(),
+                                             ".heatcommunities");
+  for (unsigned L = 0; L<Levels.size(); L++)
+    writeHeatReport(Prefix + ".level" + std::to_string(L) + ".dot",
+                    [&](raw_ostream &OS) {
+      printCommunityLevel(OS,HP,Levels[L],L);
+    });
+  writeHeatReport(Prefix + ".txt",[&](raw_ostream &OS) {
+    printCommunityMembership(OS,HP,Levels);
+  });
+  return false;
+}
+
+}
+
+char HeatCommunityPrinterPass::ID = 0;
+static RegisterPass<HeatCommunityPrinterPass> X("dot-heat-communities",
+          "Print communities of the heat call graph to 'dot' files.",
+          false, false);
@@ -0,0 +1,41 @@
+//===-- HeatCommunityPrinter.h - Call graph community printer ---*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'dot-heat-communities' analysis pass, which summarizes
+// the heat call graph of the module as a hierarchy of communities of
+// functions that call each other frequently. Each level of the hierarchy is
+// emitted to <module>.heatcommunities.level<N>.dot, with the communities as
+// nodes coloured by their hottest function, and the community of every
+// function at each level is listed in <module>.heatcommunities.txt.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATCOMMUNITYPRINTER_H
+#define LLVM_ANALYSIS_HEATCOMMUNITYPRINTER_H
+
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace {
+
+class HeatCommunityPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatCommunityPrinterPass() : HeatReportPass(ID) {}
+
+  bool runOnModule(Module &M) override;
+};
+
+}
+
+#endif
@@ -0,0 +1,45 @@
+
+#include "HeatDataCache.h"
+#include "HeatMemoryBudget.h"
+
+namespace llvm {
+
+HeatDataCache &HeatDataCache::instance(){
+  static HeatDataCache Cache;
+  return Cache;
+}
+
+HeatProfile &HeatDataCache::get(Module &M,
+                      function_ref<BlockFrequencyInfo *(Function &)> LookupBFI,
+                      const HeatProfileOptions &Opts){
+  assert(!Opts.Filter && "Filtered heat data is not cached");
+  Key K(&M,Opts.ApproxMinBlocks);
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto It = Data.find(K);
+    if (It!=Data.end())
+      return *It->second;
+  }
+
+  // A module is only processed by a single thread at a time, so no other
+  // thread adds it meanwhile.
+  std::unique_ptr<HeatProfile> HP(new HeatProfile(M,LookupBFI,Opts));
+  HeatMemoryBudget::instance().acquire(HP->getMemorySize());
+  std::lock_guard<std::mutex> Lock(Mutex);
+  std::unique_ptr<HeatProfile> &Entry = Data[K];
+  Entry = std::move(HP);
+  return *Entry;
+}
+
+void HeatDataCache::invalidate(const Module &M){
+  std::lock_guard<std::mutex> Lock(Mutex);
+  for (auto It = Data.begin(), E = Data.end(); It!=E;) {
+    auto Entry = It++;
+    if (Entry->first.first!=&M)
+      continue;
+    HeatMemoryBudget::instance().release(Entry->second->getMemorySize());
+    Data.erase(Entry);
+  }
+}
+
+}
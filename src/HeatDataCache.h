@@ -0,0 +1,70 @@
+//===-- HeatDataCache.h - Per-module heat data cache ------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a cache of the per-module heat profiles that is shared by
+// all the heat passes loaded from the same plugin, so that the heat data of a
+// module is only computed once.
+//
+// The cache assumes the module is not transformed between the heat passes,
+// which is the case for the analysis-only pipelines they are used in.
+// The heat data is cached for each set of options that changes it, so passes
+// configured differently never share it. Profiles restricted by a filter are
+// never cached. Entries are dropped when the passes are finalized.
+//
+// The cache may be used by passes running concurrently on different modules,
+// e.g. in the backends of a parallel LTO build. The heat data of a module is
+// computed without holding the lock, so that the modules do not wait for each
+// other.
+//
+// The cached heat data is accounted in the memory budget, but it is never
+// evicted, as the passes hold references to it until they are finalized.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATDATACACHE_H
+#define LLVM_ANALYSIS_HEATDATACACHE_H
+
+#include "HeatProfile.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/IR/Module.h"
+
+#include <memory>
+#include <mutex>
+
+using namespace llvm;
+
+namespace llvm {
+
+class HeatDataCache {
+public:
+  static HeatDataCache &instance();
+
+  /// Returns the heat data of \p M computed with \p Opts, computing it if it
+  /// is not cached yet. \p Opts must not have a filter.
+  HeatProfile &get(Module &M,
+                   function_ref<BlockFrequencyInfo *(Function &)> LookupBFI,
+                   const HeatProfileOptions &Opts = HeatProfileOptions());
+
+  /// Drops the heat data of \p M computed with any options.
+  void invalidate(const Module &M);
+
+private:
+  /// The module and the options its heat data was computed with.
+  typedef std::pair<const Module *, unsigned> Key;
+
+  std::mutex Mutex;
+  DenseMap<Key, std::unique_ptr<HeatProfile>> Data;
+};
+
+}
+
+#endif
@@ -0,0 +1,62 @@
+//===-- HeatIRPrinter.cpp - Heat annotated IR printer -----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-ir' analysis pass, which emits the <module>.heat.ll
+// file with the IR of the module and a heat comment for each function and
+// block.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeatIRPrinter.h"
+#include "HeatAnnotatedIR.h"
+#include "HeatPrinterOptions.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+
+using namespace llvm;
+
+
+static cl::opt<bool>
+HeatIRPerFunction("heat-ir-per-function", cl::init(false), cl::Hidden,
+                  cl::desc("Heat of the annotated IR per function"));
+
+static cl::opt<bool>
+HeatIRColor("heat-ir-color", cl::init(false), cl::Hidden,
+            cl::desc("Color the annotated IR with ANSI escape sequences"));
+
+namespace {
+
+bool HeatIRPrinterPass::runOnModule(Module &M) {
+  HeatProfile &HP = getHeatProfile(M,getHeatProfileOptions());
+  HeatIROptions Opts;
+  Opts.PerFunction = HeatIRPerFunction;
+  Opts.Color = HeatIRColor;
+
+  std::string Filename = getHeatOutputFilename(M.getModuleIdentifier(),
+                                               getHeatOutputTag(),
+                                               ".heat.ll");
+  writeHeatReport(Filename,[&](raw_ostream &OS) {
+    writeHeatAnnotatedIR(OS,HP,Opts);
+  });
+  return false;
+}
+
+}
+
+char HeatIRPrinterPass::ID = 0;
+static RegisterPass<HeatIRPrinterPass> X("heat-ir",
+          "Print the module with heat annotations to '.ll' file.",
+          false, false);
@@ -0,0 +1,37 @@
+//===-- HeatIRPrinter.h - Heat annotated IR printer -------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-ir' analysis pass, which emits the module as
+// textual IR annotated with the heat of its functions and blocks.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATIRPRINTER_H
+#define LLVM_ANALYSIS_HEATIRPRINTER_H
+
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace {
+
+class HeatIRPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatIRPrinterPass() : HeatReportPass(ID) {}
+
+  bool runOnModule(Module &M) override;
+};
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+
+#include "HeatImportHints.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/Format.h"
+
+#include <algorithm>
+
+namespace llvm {
+
+/// Returns the instruction count of the function \p GUID in \p Index, or 0
+/// if it has no function summary.
+static unsigned getSummarySize(const ModuleSummaryIndex &Index,
+                               GlobalValue::GUID GUID){
+  auto It = Index.findGlobalValueSummaryList(GUID);
+  if (It==Index.end())
+    return 0;
+  unsigned Size = 0;
+  // Linkonce functions may have a summary in several modules, the importer
+  // picks one of them, so the smallest one is taken.
+  for (const auto &Summary : It->second) {
+    const GlobalValueSummary *S = Summary.get();
+    if (const AliasSummary *AS = dyn_cast<AliasSummary>(S))
+      S = &AS->getAliasee();
+    if (const FunctionSummary *FS = dyn_cast<FunctionSummary>(S))
+      if (Size==0 || FS->instCount()<Size)
+        Size = FS->instCount();
+  }
+  return Size;
+}
+
+std::vector<HeatImportHint> getHeatImportHints(const HeatProfile &HP,
+                                               double MinHeat,
+                                               const ModuleSummaryIndex *Index){
+  std::vector<HeatImportHint> Hints;
+  DenseMap<const Function *, unsigned> HintIndex;
+  std::vector<uint64_t> HottestCalls;
+  for (unsigned FI = 0; FI<HP.getNumFunctions(); FI++) {
+    for (const HeatCallSite &Call : HP.callSites(FI)) {
+      const Function *Callee = Call.Callee;
+      if (!Callee || !Callee->isDeclaration() || Callee->isIntrinsic())
+        continue;
+      auto It = HintIndex.insert(std::make_pair(Callee,Hints.size()));
+      if (It.second) {
+        HeatImportHint New = {Callee, 0, 0, FI, 0};
+        Hints.push_back(New);
+        HottestCalls.push_back(0);
+      }
+      HeatImportHint &Hint = Hints[It.first->second];
+      Hint.Calls += Call.Freq;
+      Hint.NumCallSites++;
+      uint64_t Calls = HP.getNumOfCalls(HP.getFunction(FI),Callee);
+      if (Calls>HottestCalls[It.first->second]) {
+        HottestCalls[It.first->second] = Calls;
+        Hint.HottestCaller = FI;
+      }
+    }
+  }
+
+  Hints.erase(std::remove_if(Hints.begin(), Hints.end(),
+                             [&HP,MinHeat](const HeatImportHint &H) {
+                               return H.Calls==0 ||
+                                      HP.getHeat(H.Calls)<MinHeat;
+                             }),
+              Hints.end());
+  if (Index)
+    for (HeatImportHint &Hint : Hints)
+      Hint.Size = getSummarySize(*Index,Hint.Callee->getGUID());
+  std::stable_sort(Hints.begin(), Hints.end(),
+                   [](const HeatImportHint &A, const HeatImportHint &B) {
+                     return A.Calls>B.Calls;
+                   });
+  return Hints;
+}
+
+/// Returns the multiplier of \p ImportInstrLimit that imports a callee of
+/// \p Size instructions, in hundredths, rounded up so that it is never
+/// short of the size. It is at least 1, as smaller callees need none.
+static uint64_t getImportMultiplier(unsigned Size, unsigned ImportInstrLimit){
+  uint64_t Hundredths =
+      (uint64_t(Size)*100+ImportInstrLimit-1)/ImportInstrLimit;
+  return std::max<uint64_t>(Hundredths,100);
+}
+
+void printHeatImportHints(raw_ostream &OS, const HeatProfile &HP,
+                          ArrayRef<HeatImportHint> Hints,
+                          unsigned ImportInstrLimit){
+  OS << "# Hot cross-module callees of '"
+     << HP.getModule().getModuleIdentifier() << "'\n";
+  OS << "# The multiplier is the size of the callee over the import limit ("
+     << ImportInstrLimit << "), rounded up and at least 1, '-' when the "
+     << "size is unknown\n";
+  OS << "# -import-hot-multiplier only applies to the call edges the summary "
+     << "marks hot, the other callees need a higher -import-instr-limit\n";
+  OS << "# guid callee calls heat call-sites size multiplier hottest-caller\n";
+  uint64_t MaxMultiplier = 0;
+  for (const HeatImportHint &Hint : Hints) {
+    OS << Hint.Callee->getGUID() << " " << Hint.Callee->getName() << " "
+       << Hint.Calls << " " << format("%.4f", HP.getHeat(Hint.Calls)) << " "
+       << Hint.NumCallSites << " ";
+    if (Hint.Size && ImportInstrLimit) {
+      uint64_t Multiplier = getImportMultiplier(Hint.Size,ImportInstrLimit);
+      MaxMultiplier = std::max(MaxMultiplier,Multiplier);
+      OS << Hint.Size << " " << format("%.2f", Multiplier/100.0);
+    } else {
+      OS << "- -";
+    }
+    OS << " " << HP.getFunction(Hint.HottestCaller)->getName() << "\n";
+  }
+  if (MaxMultiplier>0)
+    OS << "# All the callees of known size reached by hot edges are imported "
+       << "with -import-hot-multiplier="
+       << format("%.2f", MaxMultiplier/100.0) << "\n";
+}
+}
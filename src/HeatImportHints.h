@@ -0,0 +1,58 @@
+//===-- HeatImportHints.h - ThinLTO import hints ----------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file defines the ThinLTO import hints of a module: its hot calls to
+// functions defined in other modules, with their number of calls and the size
+// of the callees. The size is the instruction count of the callee in a
+// combined summary index, which is what the function importer compares to
+// its import threshold, so each hint gives the threshold needed to import
+// the callee.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATIMPORTHINTS_H
+#define LLVM_ANALYSIS_HEATIMPORTHINTS_H
+
+#include "HeatProfile.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/ModuleSummaryIndex.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+struct HeatImportHint {
+  /// Declaration of the callee in the module.
+  const Function *Callee;
+  /// Number of calls, i.e. the sum of the frequencies of the call sites.
+  uint64_t Calls;
+  unsigned NumCallSites;
+  /// Index in the profile of the function calling the callee most.
+  unsigned HottestCaller;
+  /// Instruction count of the callee in the summary index, or 0 if unknown.
+  unsigned Size;
+};
+
+/// Returns the callees declared in the module of \p HP whose calls have heat
+/// of at least \p MinHeat, by decreasing number of calls. Sizes are taken
+/// from \p Index when it is not null.
+std::vector<HeatImportHint> getHeatImportHints(const HeatProfile &HP,
+                                               double MinHeat,
+                                               const ModuleSummaryIndex *Index);
+
+/// Prints the hints, one callee per line, with the import threshold needed
+/// for each callee as a multiplier of \p ImportInstrLimit, rounded up. The
+/// function importer only applies such a multiplier to hot call edges.
+void printHeatImportHints(raw_ostream &OS, const HeatProfile &HP,
+                          ArrayRef<HeatImportHint> Hints,
+                          unsigned ImportInstrLimit);
+
+}
+
+#endif
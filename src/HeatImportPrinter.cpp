@@ -0,0 +1,86 @@
+//===-- HeatImportPrinter.cpp - ThinLTO import hint printer -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-import-hints' analysis pass, which emits the
+// <module>.heatimports.txt list of the hot calls of the module to functions
+// of other modules, with their number of calls and, given the combined
+// summary index of a ThinLTO build, the size of the callees and the import
+// threshold needed to import them.
+//===----------------------------------------------------------------------===//
+
+#include "HeatImportPrinter.h"
+#include "HeatImportHints.h"
+#include "HeatPrinterOptions.h"
+#include "HeatUtils.h"
+
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+
+static cl::opt<double>
+ImportMinHeat("heat-import-min-heat", cl::init(0.01), cl::Hidden,
+              cl::desc("Minimum heat, in [0,1], of the calls of the reported "
+                       "callees"));
+
+static cl::opt<std::string>
+ImportSummary("heat-import-summary", cl::init(""), cl::Hidden,
+              cl::value_desc("filename"),
+              cl::desc("Combined summary index giving the callee sizes"));
+
+static cl::opt<unsigned>
+ImportInstrLimit("heat-import-instr-limit", cl::init(100), cl::Hidden,
+                 cl::desc("Import instruction limit of the ThinLTO build, "
+                          "as -import-instr-limit"));
+
+namespace {
+
+bool HeatImportPrinterPass::runOnModule(Module &M) {
+  HeatLog Log;
+  std::unique_ptr<ModuleSummaryIndex> Index;
+  if (!ImportSummary.empty()) {
+    Expected<std::unique_ptr<ModuleSummaryIndex>> IndexOrErr =
+        getModuleSummaryIndexForFile(ImportSummary);
+    if (IndexOrErr)
+      Index = std::move(*IndexOrErr);
+    else
+      Log << "warning: cannot read '" << ImportSummary << "': "
+          << toString(IndexOrErr.takeError())
+          << ", the callee sizes are unknown\n";
+  }
+
+  HeatProfile &HP = getHeatProfile(M,getHeatProfileOptions());
+  std::vector<HeatImportHint> Hints =
+      getHeatImportHints(HP,ImportMinHeat,Index.get());
+
+  std::string Filename = getHeatOutputFilename(M.getModuleIdentifier(),
+                                               getHeatOutputTag(),
+                                               ".heatimports.txt");
+  writeHeatReport(Filename,[&](raw_ostream &OS) {
+    printHeatImportHints(OS,HP,Hints,ImportInstrLimit);
+  });
+  return false;
+}
+
+}
+
+char HeatImportPrinterPass::ID = 0;
+static RegisterPass<HeatImportPrinterPass> X("heat-import-hints",
+          "Print the hot cross-module callees as ThinLTO import hints.",
+          false, false);
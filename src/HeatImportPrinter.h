@@ -0,0 +1,37 @@
+//===-- HeatImportPrinter.h - ThinLTO import hint printer -------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-import-hints' analysis pass, which emits the
+// <module>.heatimports.txt list of hot cross-module callees for ThinLTO.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATIMPORTPRINTER_H
+#define LLVM_ANALYSIS_HEATIMPORTPRINTER_H
+
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace {
+
+class HeatImportPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatImportPrinterPass() : HeatReportPass(ID) {}
+
+  bool runOnModule(Module &M) override;
+};
+
+}
+
+#endif
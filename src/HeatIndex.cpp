@@ -0,0 +1,98 @@
+
+#include "HeatIndex.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+
+namespace llvm {
+
+void HeatIndex::sort(){
+  std::stable_sort(Entries.begin(), Entries.end(),
+                   [](const HeatIndexEntry &A, const HeatIndexEntry &B) {
+                     return A.MaxFreq>B.MaxFreq;
+                   });
+}
+
+void HeatIndex::print(raw_ostream &OS) const {
+  OS << "heat-index 1\n";
+  OS << "shard " << Shard.Index << " " << Shard.Count << "\n";
+  OS << "max-freq " << MaxFreq << "\n";
+  if (NumSkipped)
+    OS << "skipped " << NumSkipped << "\n";
+  for (const HeatIndexEntry &Entry : Entries)
+    OS << Entry.MaxFreq << " " << Entry.Filename << " " << Entry.Function
+       << "\n";
+}
+
+bool HeatIndex::write(StringRef Filename) const {
+  std::error_code EC;
+  raw_fd_ostream File(Filename, EC, sys::fs::F_Text);
+  if (EC)
+    return false;
+  print(File);
+  return true;
+}
+
+bool HeatIndex::read(StringRef Filename, HeatIndex &Index,
+                     std::string &Error){
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Buffer =
+      MemoryBuffer::getFile(Filename);
+  if (!Buffer) {
+    Error = Buffer.getError().message();
+    return false;
+  }
+
+  SmallVector<StringRef, 16> Lines;
+  (*Buffer)->getBuffer().split(Lines, '\n', -1, false);
+  if (Lines.size()<3 || Lines[0].rtrim()!="heat-index 1") {
+    Error = "not a heat index file";
+    return false;
+  }
+
+  Index = HeatIndex();
+  std::pair<StringRef, StringRef> Shard;
+  bool Malformed = !Lines[1].consume_front("shard ");
+  if (!Malformed) {
+    Shard = Lines[1].rtrim().split(' ');
+    Malformed = Shard.first.getAsInteger(10,Index.Shard.Index) ||
+                Shard.second.getAsInteger(10,Index.Shard.Count) ||
+                !Lines[2].consume_front("max-freq ") ||
+                Lines[2].rtrim().getAsInteger(10,Index.MaxFreq) ||
+                Index.Shard.Count==0 || Index.Shard.Index>=Index.Shard.Count;
+  }
+  if (Malformed) {
+    Error = "malformed heat index header";
+    return false;
+  }
+
+  unsigned First = 3;
+  StringRef Skipped = (Lines.size()>First)?Lines[First]:StringRef();
+  if (Skipped.consume_front("skipped ")) {
+    if (Skipped.rtrim().getAsInteger(10,Index.NumSkipped)) {
+      Error = "malformed heat index header";
+      return false;
+    }
+    First++;
+  }
+
+  for (unsigned i = First; i<Lines.size(); i++) {
+    std::pair<StringRef, StringRef> Freq = Lines[i].rtrim().split(' ');
+    std::pair<StringRef, StringRef> Names = Freq.second.split(' ');
+    HeatIndexEntry Entry;
+    if (Freq.first.getAsInteger(10,Entry.MaxFreq) || Names.first.empty() ||
+        Names.second.empty()) {
+      Error = "malformed heat index entry at line " + std::to_string(i+1);
+      return false;
+    }
+    Entry.Filename = Names.first.str();
+    Entry.Function = Names.second.str();
+    Index.Entries.push_back(Entry);
+  }
+  return true;
+}
+
+}
@@ -0,0 +1,68 @@
+//===-- HeatIndex.h - Index of heat output files ----------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the index of the heat CFG files written for a module,
+// listing the file of each function with its maximum frequency. The indices
+// written by the shards of a module are merged by the heat-merge tool.
+//
+// The index file has the format:
+//   heat-index 1
+//   shard <i> <N>
+//   max-freq <freq>
+//   [skipped <number of functions>]
+//   <freq> <file name> <function name>
+//   ...
+//
+// The skipped line is only present when the time budget of the printer ran
+// out before the CFGs of all the functions were written.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATINDEX_H
+#define LLVM_ANALYSIS_HEATINDEX_H
+
+#include "HeatSummary.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+struct HeatIndexEntry {
+  uint64_t MaxFreq;
+  std::string Filename;
+  std::string Function;
+};
+
+struct HeatIndex {
+  HeatShard Shard;
+  uint64_t MaxFreq = 0;
+  /// Number of functions whose CFG was not written, as the time budget ran
+  /// out. They are colder than all the listed ones.
+  unsigned NumSkipped = 0;
+  std::vector<HeatIndexEntry> Entries;
+
+  /// Sorts the entries from the hottest function.
+  void sort();
+
+  void print(raw_ostream &OS) const;
+
+  bool write(StringRef Filename) const;
+
+  static bool read(StringRef Filename, HeatIndex &Index, std::string &Error);
+};
+
+}
+
+#endif
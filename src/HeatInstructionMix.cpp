@@ -0,0 +1,157 @@
+
+#include "HeatInstructionMix.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Type.h"
+#include "llvm/Support/Format.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace llvm {
+
+static const char *const CategoryNames[HIC_NumCategories] = {
+  "load", "store", "branch", "call", "fp", "vector"
+};
+
+HeatInstructionMix::HeatInstructionMix() : Total(0) {
+  std::fill(Opcodes, Opcodes+Instruction::OtherOpsEnd, 0);
+  std::fill(Categories, Categories+HIC_NumCategories, 0);
+}
+
+static bool isFPInstruction(const Instruction &I){
+  if (I.getType()->getScalarType()->isFloatingPointTy())
+    return true;
+  // Compares and stores of floating-point values have no FP result.
+  if (isa<FCmpInst>(I) || isa<FPToUIInst>(I) || isa<FPToSIInst>(I))
+    return true;
+  if (const StoreInst *SI = dyn_cast<StoreInst>(&I))
+    return SI->getValueOperand()->getType()->getScalarType()
+             ->isFloatingPointTy();
+  return false;
+}
+
+static bool isVectorInstruction(const Instruction &I){
+  if (I.getType()->isVectorTy())
+    return true;
+  if (isa<ExtractElementInst>(I))
+    return true;
+  if (const StoreInst *SI = dyn_cast<StoreInst>(&I))
+    return SI->getValueOperand()->getType()->isVectorTy();
+  return false;
+}
+
+void HeatInstructionMix::add(const Instruction &I, uint64_t Freq){
+  Opcodes[I.getOpcode()] += Freq;
+  Total += Freq;
+
+  switch (I.getOpcode()) {
+  case Instruction::Load:
+    Categories[HIC_Load] += Freq;
+    break;
+  case Instruction::Store:
+    Categories[HIC_Store] += Freq;
+    break;
+  case Instruction::Br:
+  case Instruction::Switch:
+  case Instruction::IndirectBr:
+    Categories[HIC_Branch] += Freq;
+    break;
+  case Instruction::Call:
+  case Instruction::Invoke:
+    Categories[HIC_Call] += Freq;
+    break;
+  default:
+    break;
+  }
+  if (isFPInstruction(I))
+    Categories[HIC_FP] += Freq;
+  if (isVectorInstruction(I))
+    Categories[HIC_Vector] += Freq;
+}
+
+HeatModuleMix HeatModuleMix::get(const HeatProfile &HP){
+  HeatModuleMix Mix;
+  Mix.Functions.resize(HP.getNumFunctions());
+  ArrayRef<const BasicBlock *> Blocks = HP.blocks();
+  ArrayRef<uint64_t> Freqs = HP.blockFreqs();
+  unsigned FI = 0;
+  for (unsigned BI = 0; BI<Blocks.size(); BI++) {
+    // Blocks of a function are contiguous and functions are in order.
+    while (BI>=HP.getFirstBlock(FI)+HP.blocks(FI).size())
+      FI++;
+    uint64_t Freq = Freqs[BI];
+    if (Freq==0)
+      continue;
+    for (const Instruction &I : *Blocks[BI]) {
+      Mix.Module.add(I,Freq);
+      Mix.Functions[FI].add(I,Freq);
+    }
+  }
+  return Mix;
+}
+
+static double getPercent(uint64_t Count, uint64_t Total){
+  return Total?100.0*Count/Total:0.0;
+}
+
+/// Prints the executed opcodes of \p Mix from the most executed one, with
+/// their share of its instructions.
+static void printOpcodes(raw_ostream &OS, const HeatInstructionMix &Mix,
+                         StringRef Indent){
+  std::vector<std::pair<uint64_t, unsigned>> Opcodes;
+  for (unsigned Op = 0; Op<Instruction::OtherOpsEnd; Op++)
+    if (Mix.Opcodes[Op])
+      Opcodes.push_back(std::make_pair(Mix.Opcodes[Op],Op));
+  std::sort(Opcodes.rbegin(), Opcodes.rend());
+  for (auto &Op : Opcodes)
+    OS << Indent << Instruction::getOpcodeName(Op.second) << " " << Op.first
+       << " " << format("%.2f", getPercent(Op.first,Mix.Total)) << "\n";
+}
+
+void HeatModuleMix::print(raw_ostream &OS, const HeatProfile &HP,
+                          unsigned NumFunctions) const {
+  OS << "dynamic instruction mix of '"
+     << HP.getModule().getModuleIdentifier() << "'";
+  if (!HP.hasProfiling())
+    OS << " (estimated without profile)";
+  OS << "\n";
+  OS << "total " << Module.Total << "\n\n";
+
+  OS << "# category count percent\n";
+  for (unsigned C = 0; C<HIC_NumCategories; C++)
+    OS << CategoryNames[C] << " " << Module.Categories[C] << " "
+       << format("%.2f", getPercent(Module.Categories[C],Module.Total))
+       << "\n";
+  OS << "\n";
+
+  OS << "# opcode count percent\n";
+  printOpcodes(OS,Module,"");
+  OS << "\n";
+
+  OS << "# function total";
+  for (unsigned C = 0; C<HIC_NumCategories; C++)
+    OS << " " << CategoryNames[C] << "%";
+  OS << ", followed by its opcode count percent\n";
+  std::vector<unsigned> Order(Functions.size());
+  for (unsigned FI = 0; FI<Functions.size(); FI++)
+    Order[FI] = FI;
+  std::stable_sort(Order.begin(), Order.end(), [this](unsigned A, unsigned B) {
+    return Functions[A].Total>Functions[B].Total;
+  });
+  for (unsigned i = 0; i<Order.size() && i<NumFunctions; i++) {
+    const HeatInstructionMix &F = Functions[Order[i]];
+    if (F.Total==0)
+      break;
+    OS << HP.getFunction(Order[i])->getName() << " " << F.Total;
+    for (unsigned C = 0; C<HIC_NumCategories; C++)
+      OS << " " << format("%.2f", getPercent(F.Categories[C],F.Total));
+    OS << "\n";
+    printOpcodes(OS,F,"  ");
+  }
+}
+
+}
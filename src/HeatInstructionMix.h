@@ -0,0 +1,71 @@
+//===-- HeatInstructionMix.h - Dynamic instruction mix ----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the dynamic instruction mix of a module: the number of
+// executed instructions per opcode and per category, estimated by weighting
+// the instructions of each block with its frequency. It characterizes a
+// workload without hardware counters.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATINSTRUCTIONMIX_H
+#define LLVM_ANALYSIS_HEATINSTRUCTIONMIX_H
+
+#include "HeatProfile.h"
+
+#include "llvm/IR/Instruction.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+enum HeatInstCategory {
+  HIC_Load,
+  HIC_Store,
+  HIC_Branch,
+  HIC_Call,
+  HIC_FP,
+  HIC_Vector,
+  HIC_NumCategories
+};
+
+struct HeatInstructionMix {
+  /// Executed instructions per opcode, indexed by opcode.
+  uint64_t Opcodes[Instruction::OtherOpsEnd];
+  /// Executed instructions per category. An instruction may be in several
+  /// categories, e.g. a vector floating-point load, or in none.
+  uint64_t Categories[HIC_NumCategories];
+  uint64_t Total;
+
+  HeatInstructionMix();
+
+  void add(const Instruction &I, uint64_t Freq);
+};
+
+struct HeatModuleMix {
+  HeatInstructionMix Module;
+  /// Indexed by function index of the profile.
+  std::vector<HeatInstructionMix> Functions;
+
+  /// Computes the mix of the functions of \p HP in a single walk over their
+  /// blocks.
+  static HeatModuleMix get(const HeatProfile &HP);
+
+  /// Prints the mix of the module, and the mix of the \p NumFunctions
+  /// functions with most executed instructions, with their opcodes.
+  void print(raw_ostream &OS, const HeatProfile &HP,
+             unsigned NumFunctions) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,69 @@
+
+#include "HeatMemoryBudget.h"
+#include "HeatUtils.h"
+
+#include "llvm/Support/Format.h"
+
+namespace llvm {
+
+HeatMemoryBudget &HeatMemoryBudget::instance(){
+  static HeatMemoryBudget Budget;
+  return Budget;
+}
+
+void HeatMemoryBudget::updatePeak(uint64_t NewUsage){
+  uint64_t OldPeak = Peak;
+  while (NewUsage>OldPeak && !Peak.compare_exchange_weak(OldPeak,NewUsage))
+    ;
+}
+
+void HeatMemoryBudget::acquire(uint64_t Bytes){
+  updatePeak(Usage += Bytes);
+}
+
+bool HeatMemoryBudget::tryAcquire(uint64_t Bytes){
+  if (!hasLimit()) {
+    acquire(Bytes);
+    return true;
+  }
+  uint64_t Old = Usage;
+  do {
+    if (Old+Bytes>getLimit())
+      return false;
+  } while (!Usage.compare_exchange_weak(Old,Old+Bytes));
+  updatePeak(Old+Bytes);
+  return true;
+}
+
+void HeatMemoryBudget::release(uint64_t Bytes){
+  Usage -= Bytes;
+}
+
+bool HeatMemoryBudget::isNearLimit() const {
+  return hasLimit() && Usage>=getLimit()/4*3;
+}
+
+bool HeatMemoryBudget::isOverLimit() const {
+  return hasLimit() && Usage>getLimit();
+}
+
+void HeatMemoryBudget::report() const {
+  HeatLog Log;
+  Log << "Heat memory peak " << format("%.1f", double(Peak)/(1 << 20))
+      << " MB";
+  if (hasLimit())
+    Log << " of a budget of " << LimitMB << " MB";
+  Log << "\n";
+}
+
+void HeatMemoryBudget::finalize(){
+  if (!hasLimit())
+    return;
+  uint64_t Reported = ReportedPeak;
+  uint64_t Current = Peak;
+  if (Current!=Reported &&
+      ReportedPeak.compare_exchange_strong(Reported,Current))
+    report();
+}
+
+}
@@ -0,0 +1,78 @@
+//===-- HeatMemoryBudget.h - Memory budget of the heat passes ---*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the process-wide accounting of the memory held by the heat
+// data, the cached block frequency analyses and the output buffers, against
+// the limit given by -heat-memory-budget.
+//
+// The budget does not fail allocations. The data needed anyway is always
+// accounted for, and the optional buffers are only kept when they fit, so
+// that the heat passes switch to cheaper modes near the limit: fewer cached
+// analyses, shorter output queues, simple labels and files written directly
+// instead of through buffers.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATMEMORYBUDGET_H
+#define LLVM_ANALYSIS_HEATMEMORYBUDGET_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace llvm {
+
+class HeatMemoryBudget {
+public:
+  static HeatMemoryBudget &instance();
+
+  /// Limit in megabytes, 0 for no limit. It is set from the command line
+  /// before the passes run, and only read afterwards.
+  unsigned LimitMB = 0;
+
+  bool hasLimit() const { return LimitMB!=0; }
+  uint64_t getLimit() const { return uint64_t(LimitMB) << 20; }
+
+  /// Accounts for \p Bytes that are needed anyway, even above the limit.
+  void acquire(uint64_t Bytes);
+
+  /// Accounts for \p Bytes only if they fit in the limit.
+  bool tryAcquire(uint64_t Bytes);
+
+  void release(uint64_t Bytes);
+
+  /// Returns true once 3/4 of the limit are in use, when the optional
+  /// buffers are given up.
+  bool isNearLimit() const;
+
+  bool isOverLimit() const;
+
+  uint64_t getUsage() const { return Usage; }
+  uint64_t getPeakUsage() const { return Peak; }
+
+  /// Logs the peak usage against the limit.
+  void report() const;
+
+  /// Called when a heat pass is finalized, after all the passes of its pass
+  /// manager ran. With a limit, logs the peak usage if it was not reported
+  /// yet, so that a run reports it once whichever heat passes it had.
+  void finalize();
+
+private:
+  HeatMemoryBudget() : Usage(0), Peak(0), ReportedPeak(0) {}
+
+  void updatePeak(uint64_t NewUsage);
+
+  std::atomic<uint64_t> Usage;
+  std::atomic<uint64_t> Peak;
+  std::atomic<uint64_t> ReportedPeak;
+};
+
+}
+
+#endif
@@ -0,0 +1,57 @@
+//===-- HeatMixPrinter.cpp - Instruction mix printer ------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-inst-mix' analysis pass, which emits the
+// <module>.heatmix.txt report with the number of executed instructions per
+// opcode and per category, over the module and per function.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeatMixPrinter.h"
+#include "HeatInstructionMix.h"
+#include "HeatPrinterOptions.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+
+using namespace llvm;
+
+
+static cl::opt<unsigned>
+MixFunctions("heat-mix-functions", cl::init(20), cl::Hidden,
+             cl::desc("Number of functions with most executed instructions "
+                      "reported"));
+
+namespace {
+
+bool HeatMixPrinterPass::runOnModule(Module &M) {
+  HeatProfile &HP = getHeatProfile(M,getHeatProfileOptions());
+  HeatModuleMix Mix = HeatModuleMix::get(HP);
+
+  std::string Filename = getHeatOutputFilename(M.getModuleIdentifier(),
+                                               getHeatOutputTag(),
+                                               ".heatmix.txt");
+  writeHeatReport(Filename,[&](raw_ostream &OS) {
+    Mix.print(OS,HP,MixFunctions);
+  });
+  return false;
+}
+
+}
+
+char HeatMixPrinterPass::ID = 0;
+static RegisterPass<HeatMixPrinterPass> X("heat-inst-mix",
+          "Print the dynamic instruction mix of the module.",
+          false, false);
@@ -0,0 +1,37 @@
+//===-- HeatMixPrinter.h - Instruction mix printer --------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-inst-mix' analysis pass, which emits the
+// <module>.heatmix.txt report of the dynamic instruction mix.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATMIXPRINTER_H
+#define LLVM_ANALYSIS_HEATMIXPRINTER_H
+
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace {
+
+class HeatMixPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatMixPrinterPass() : HeatReportPass(ID) {}
+
+  bool runOnModule(Module &M) override;
+};
+
+}
+
+#endif
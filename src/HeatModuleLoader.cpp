@@ -0,0 +1,48 @@
+
+#include "HeatModuleLoader.h"
+
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/DiagnosticPrinter.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/Instrumentation.h"
+
+namespace llvm {
+
+static void diagnosticHandler(const DiagnosticInfo &DI, void *Context){
+  if (DI.getSeverity()!=DS_Error)
+    return;
+  std::string *Error = static_cast<std::string *>(Context);
+  raw_string_ostream OS(*Error);
+  DiagnosticPrinterRawOStream DP(OS);
+  DI.print(DP);
+  OS << "\n";
+}
+
+std::unique_ptr<Module> loadHeatModule(StringRef BitcodePath,
+                                       StringRef ProfilePath,
+                                       LLVMContext &Context,
+                                       std::string &Error){
+  Error.clear();
+
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseIRFile(BitcodePath, Err, Context);
+  if (!M) {
+    raw_string_ostream OS(Error);
+    Err.print("heat", OS, false);
+    return nullptr;
+  }
+
+  if (!ProfilePath.empty()) {
+    Context.setDiagnosticHandler(diagnosticHandler, &Error);
+    legacy::PassManager PM;
+    PM.add(createPGOInstrumentationUseLegacyPass(ProfilePath));
+    PM.run(*M);
+    Context.setDiagnosticHandler(nullptr);
+  }
+  return M;
+}
+
+}
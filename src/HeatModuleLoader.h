@@ -0,0 +1,41 @@
+//===-- HeatModuleLoader.h - Load modules for heat tools --------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the loading of a module from bitcode, optionally
+// annotated with an instrumentation profile (.profdata), for the tools that
+// use the heat library outside of 'opt'.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATMODULELOADER_H
+#define LLVM_ANALYSIS_HEATMODULELOADER_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+namespace llvm {
+
+/// Loads the module in \p BitcodePath and, if \p ProfilePath is not empty,
+/// annotates it with the profile in that file. Returns null and sets
+/// \p Error if the module cannot be read. If the module is read but the
+/// profile cannot be applied, the module is returned and \p Error is set.
+std::unique_ptr<Module> loadHeatModule(StringRef BitcodePath,
+                                       StringRef ProfilePath,
+                                       LLVMContext &Context,
+                                       std::string &Error);
+
+}
+
+#endif
@@ -0,0 +1,419 @@
+
+#include "HeatOutputStore.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/InlineAsm.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Operator.h"
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/Path.h"
+
+#include <unistd.h>
+
+namespace llvm {
+
+static void updateHash(MD5 &Hash, uint64_t Value){
+  Hash.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(&Value),
+                                sizeof(Value)));
+}
+
+namespace {
+
+/// Hashes the structure of a function: its signature, and the opcodes, types,
+/// operands and metadata of its instructions. The IR is not printed, as that
+/// numbers the metadata and unnamed globals of the whole module, which is
+/// slow and changes the text of a function when others are edited. Instead,
+/// arguments, blocks and instructions are hashed by their position in the
+/// function, globals by their name, and metadata by its contents.
+class FunctionHasher {
+public:
+  explicit FunctionHasher(MD5 &Hash) : Hash(Hash) {}
+
+  void hashFunction(const Function &F);
+
+private:
+  MD5 &Hash;
+  DenseMap<const Value *, unsigned> Locals;
+  DenseMap<const Constant *, unsigned> Constants;
+  DenseMap<const Metadata *, unsigned> Nodes;
+
+  void hashInt(uint64_t Value) { updateHash(Hash,Value); }
+  void hashString(StringRef Str);
+  void hashAPInt(const APInt &Value);
+  void hashType(Type *T);
+  void hashAttributes(AttributeList Attrs, unsigned NumArgs);
+  void hashValue(const Value *V);
+  void hashConstant(const Constant *C);
+  void hashMetadata(const Metadata *MD);
+  void hashInstruction(const Instruction &I);
+};
+
+}
+
+void FunctionHasher::hashString(StringRef Str){
+  hashInt(Str.size());
+  Hash.update(Str);
+}
+
+void FunctionHasher::hashAPInt(const APInt &Value){
+  hashInt(Value.getBitWidth());
+  for (unsigned i = 0; i<Value.getNumWords(); i++)
+    hashInt(Value.getRawData()[i]);
+}
+
+void FunctionHasher::hashType(Type *T){
+  hashInt(T->getTypeID());
+  if (StructType *ST = dyn_cast<StructType>(T)) {
+    // Named structures may be recursive, and are known by their name.
+    if (ST->hasName()) {
+      hashString(ST->getName());
+      return;
+    }
+    hashInt(ST->isPacked());
+  } else if (IntegerType *IT = dyn_cast<IntegerType>(T)) {
+    hashInt(IT->getBitWidth());
+  } else if (PointerType *PT = dyn_cast<PointerType>(T)) {
+    hashInt(PT->getAddressSpace());
+  } else if (ArrayType *AT = dyn_cast<ArrayType>(T)) {
+    hashInt(AT->getNumElements());
+  } else if (VectorType *VT = dyn_cast<VectorType>(T)) {
+    hashInt(VT->getNumElements());
+  } else if (FunctionType *FT = dyn_cast<FunctionType>(T)) {
+    hashInt(FT->isVarArg());
+  }
+  hashInt(T->getNumContainedTypes());
+  for (Type *Sub : T->subtypes())
+    hashType(Sub);
+}
+
+void FunctionHasher::hashAttributes(AttributeList Attrs, unsigned NumArgs){
+  hashString(Attrs.getAsString(AttributeList::FunctionIndex));
+  hashString(Attrs.getAsString(AttributeList::ReturnIndex));
+  for (unsigned i = 0; i<NumArgs; i++)
+    hashString(Attrs.getAsString(AttributeList::FirstArgIndex+i));
+}
+
+void FunctionHasher::hashValue(const Value *V){
+  if (!V) {
+    hashInt(0);
+    return;
+  }
+  auto It = Locals.find(V);
+  if (It!=Locals.end()) {
+    hashInt('L');
+    hashInt(It->second);
+  } else if (const Constant *C = dyn_cast<Constant>(V)) {
+    hashConstant(C);
+  } else if (const MetadataAsValue *MV = dyn_cast<MetadataAsValue>(V)) {
+    hashInt('M');
+    hashMetadata(MV->getMetadata());
+  } else if (const InlineAsm *IA = dyn_cast<InlineAsm>(V)) {
+    hashInt('A');
+    hashString(IA->getAsmString());
+    hashString(IA->getConstraintString());
+    hashInt(IA->hasSideEffects());
+  } else {
+    hashInt(V->getValueID());
+  }
+}
+
+void FunctionHasher::hashConstant(const Constant *C){
+  if (const GlobalValue *GV = dyn_cast<GlobalValue>(C)) {
+    // Unnamed globals are only told apart by their slot number in the
+    // module, which depends on the other functions.
+    hashInt('G');
+    hashString(GV->getName());
+    hashType(GV->getType());
+    return;
+  }
+  auto Inserted = Constants.insert(std::make_pair(C,Constants.size()));
+  if (!Inserted.second) {
+    hashInt('C');
+    hashInt(Inserted.first->second);
+    return;
+  }
+
+  hashInt(C->getValueID());
+  hashType(C->getType());
+  if (const ConstantInt *CI = dyn_cast<ConstantInt>(C)) {
+    hashAPInt(CI->getValue());
+  } else if (const ConstantFP *CFP = dyn_cast<ConstantFP>(C)) {
+    hashAPInt(CFP->getValueAPF().bitcastToAPInt());
+  } else if (const ConstantDataSequential *CDS =
+                 dyn_cast<ConstantDataSequential>(C)) {
+    hashString(CDS->getRawDataValues());
+  } else if (const ConstantExpr *CE = dyn_cast<ConstantExpr>(C)) {
+    hashInt(CE->getOpcode());
+    hashInt(CE->getRawSubclassOptionalData());
+    if (CE->isCompare())
+      hashInt(CE->getPredicate());
+    if (const GEPOperator *GEP = dyn_cast<GEPOperator>(CE))
+      hashType(GEP->getSourceElementType());
+  }
+  hashInt(C->getNumOperands());
+  for (const Value *Op : C->operands())
+    hashValue(Op);
+}
+
+void FunctionHasher::hashMetadata(const Metadata *MD){
+  if (!MD) {
+    hashInt(0);
+    return;
+  }
+  if (const MDString *S = dyn_cast<MDString>(MD)) {
+    hashInt('S');
+    hashString(S->getString());
+    return;
+  }
+  if (const ValueAsMetadata *VM = dyn_cast<ValueAsMetadata>(MD)) {
+    hashInt('V');
+    hashValue(VM->getValue());
+    return;
+  }
+  auto Inserted = Nodes.insert(std::make_pair(MD,Nodes.size()));
+  if (!Inserted.second) {
+    hashInt('N');
+    hashInt(Inserted.first->second);
+    return;
+  }
+
+  hashInt(MD->getMetadataID());
+  // Debug info nodes lead to the whole compile unit, so only the fields that
+  // identify a location or a variable are hashed.
+  if (const DILocation *Loc = dyn_cast<DILocation>(MD)) {
+    hashInt(Loc->getLine());
+    hashInt(Loc->getColumn());
+    hashMetadata(Loc->getScope());
+    hashMetadata(Loc->getInlinedAt());
+  } else if (const DIScope *Scope = dyn_cast<DIScope>(MD)) {
+    hashString(Scope->getName());
+    hashString(Scope->getFilename());
+  } else if (const DIVariable *Var = dyn_cast<DIVariable>(MD)) {
+    hashString(Var->getName());
+    hashInt(Var->getLine());
+  } else if (const DIExpression *Expr = dyn_cast<DIExpression>(MD)) {
+    for (uint64_t Op : Expr->getElements())
+      hashInt(Op);
+  } else if (const MDNode *N = dyn_cast<MDNode>(MD)) {
+    if (isa<DINode>(N))
+      return;
+    hashInt(N->getNumOperands());
+    for (const MDOperand &Op : N->operands())
+      hashMetadata(Op.get());
+  }
+}
+
+void FunctionHasher::hashInstruction(const Instruction &I){
+  hashInt(I.getOpcode());
+  hashType(I.getType());
+  hashInt(I.getRawSubclassOptionalData());
+  if (const CmpInst *Cmp = dyn_cast<CmpInst>(&I)) {
+    hashInt(Cmp->getPredicate());
+  } else if (const AllocaInst *AI = dyn_cast<AllocaInst>(&I)) {
+    hashType(AI->getAllocatedType());
+    hashInt(AI->getAlignment());
+  } else if (const LoadInst *LI = dyn_cast<LoadInst>(&I)) {
+    hashInt(LI->getAlignment());
+    hashInt(LI->isVolatile());
+    hashInt(unsigned(LI->getOrdering()));
+  } else if (const StoreInst *SI = dyn_cast<StoreInst>(&I)) {
+    hashInt(SI->getAlignment());
+    hashInt(SI->isVolatile());
+    hashInt(unsigned(SI->getOrdering()));
+  } else if (const GetElementPtrInst *GEP = dyn_cast<GetElementPtrInst>(&I)) {
+    hashType(GEP->getSourceElementType());
+  } else if (const PHINode *PN = dyn_cast<PHINode>(&I)) {
+    // The incoming blocks of PHIs are not operands.
+    for (const BasicBlock *BB : PN->blocks())
+      hashValue(BB);
+  } else if (const ExtractValueInst *EVI = dyn_cast<ExtractValueInst>(&I)) {
+    for (unsigned Idx : EVI->indices())
+      hashInt(Idx);
+  } else if (const InsertValueInst *IVI = dyn_cast<InsertValueInst>(&I)) {
+    for (unsigned Idx : IVI->indices())
+      hashInt(Idx);
+  } else if (ImmutableCallSite CS = ImmutableCallSite(&I)) {
+    hashInt(CS.getCallingConv());
+    hashAttributes(CS.getAttributes(),CS.arg_size());
+  }
+
+  hashInt(I.getNumOperands());
+  for (const Value *Op : I.operands())
+    hashValue(Op);
+
+  SmallVector<std::pair<unsigned, MDNode *>, 4> MDs;
+  I.getAllMetadata(MDs);
+  for (const auto &MD : MDs) {
+    hashInt(MD.first);
+    hashMetadata(MD.second);
+  }
+}
+
+void FunctionHasher::hashFunction(const Function &F){
+  // Local values are numbered first, as instructions may use values defined
+  // later in the function.
+  for (const Argument &A : F.args())
+    Locals[&A] = Locals.size();
+  for (const BasicBlock &BB : F) {
+    Locals[&BB] = Locals.size();
+    for (const Instruction &I : BB)
+      Locals[&I] = Locals.size();
+  }
+
+  hashString(F.getName());
+  hashType(F.getFunctionType());
+  hashInt(F.getLinkage());
+  hashInt(F.getCallingConv());
+  hashAttributes(F.getAttributes(),F.arg_size());
+  hashValue(F.hasPersonalityFn()?F.getPersonalityFn():nullptr);
+
+  SmallVector<std::pair<unsigned, MDNode *>, 4> MDs;
+  F.getAllMetadata(MDs);
+  for (const auto &MD : MDs) {
+    hashInt(MD.first);
+    hashMetadata(MD.second);
+  }
+
+  for (const BasicBlock &BB : F) {
+    hashInt(BB.size());
+    for (const Instruction &I : BB)
+      hashInstruction(I);
+  }
+}
+
+/// Hashes the structure of the function and its metadata, including the
+/// profile metadata, on which both the input and the output keys depend.
+static void updateHash(MD5 &Hash, const Function &F){
+  FunctionHasher(Hash).hashFunction(F);
+}
+
+static std::string getKey(MD5 &Hash){
+  MD5::MD5Result Result;
+  Hash.final(Result);
+  SmallString<32> Key;
+  MD5::stringifyResult(Result, Key);
+  return std::string(Key.str());
+}
+
+std::string HeatOutputStore::getFunctionInputKey(const Function &F){
+  MD5 Hash;
+  Hash.update("heat-input 2");
+  updateHash(Hash,F);
+  return getKey(Hash);
+}
+
+std::string HeatOutputStore::getFunctionKey(const Function &F,
+                                            const HeatProfile &HP,
+                                            StringRef Options,
+                                            uint64_t MaxFreq){
+  MD5 Hash;
+  Hash.update("heat-store 3");
+  updateHash(Hash,F);
+
+  int FI = HP.getFunctionIndex(&F);
+  if (FI>=0) {
+    updateHash(Hash,HP.getFunctionEntryCount(FI));
+    for (uint64_t Freq : HP.blockFreqs(FI))
+      updateHash(Hash,Freq);
+    unsigned FirstBlock = HP.getFirstBlock(FI);
+    for (unsigned BI = 0; BI<HP.blocks(FI).size(); BI++)
+      for (uint64_t Freq : HP.edgeFreqs(FirstBlock+BI))
+        updateHash(Hash,Freq);
+  }
+
+  Hash.update(Options);
+  updateHash(Hash,MaxFreq);
+  return getKey(Hash);
+}
+
+std::string HeatOutputStore::getObjectPath(StringRef Key) const {
+  SmallString<256> Path(Dir);
+  sys::path::append(Path, Key.substr(0,2), Key + ".dot");
+  return std::string(Path.str());
+}
+
+static bool linkOrCopy(StringRef From, StringRef To){
+  bool Result = false;
+  if (sys::fs::equivalent(From, To, Result)==std::error_code() && Result)
+    return true;
+  sys::fs::remove(To);
+  if (!sys::fs::create_hard_link(From, To))
+    return true;
+  // Hard links are not possible across file systems.
+  return !sys::fs::copy_file(From, To);
+}
+
+bool HeatOutputStore::link(StringRef Key, StringRef Filename){
+  std::string Object = getObjectPath(Key);
+
+  int FD;
+  if (sys::fs::openFileForRead(Object, FD))
+    return false;
+  // Mark the stored file as recently used for the garbage collection.
+  sys::fs::setLastModificationAndAccessTime(FD,
+                                            std::chrono::system_clock::now());
+  ::close(FD);
+
+  return linkOrCopy(Object, Filename);
+}
+
+bool HeatOutputStore::store(StringRef Key, StringRef Filename,
+                            function_ref<void(raw_ostream &)> Write){
+  std::string Object = getObjectPath(Key);
+  if (sys::fs::create_directories(sys::path::parent_path(Object)))
+    return false;
+
+  // Write to a temporary file first, so that concurrent runs sharing the
+  // store never link a partially written file.
+  int FD;
+  SmallString<256> TempPath;
+  if (sys::fs::createUniqueFile(Object + ".tmp%%%%%%", FD, TempPath))
+    return false;
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    Write(OS);
+    if (OS.has_error()) {
+      OS.clear_error();
+      sys::fs::remove(TempPath);
+      return false;
+    }
+  }
+  if (sys::fs::rename(TempPath, Object)) {
+    sys::fs::remove(TempPath);
+    return false;
+  }
+  return linkOrCopy(Object, Filename);
+}
+
+unsigned HeatOutputStore::collectGarbage(std::chrono::seconds MaxAge){
+  auto Limit = std::chrono::system_clock::now() - MaxAge;
+  unsigned Removed = 0;
+  std::error_code EC;
+  for (sys::fs::recursive_directory_iterator It(Dir, EC), End;
+       It!=End && !EC; It.increment(EC)) {
+    // Temporary files are left behind by interrupted stores; those still
+    // being written are recent, so they are kept by the age limit.
+    StringRef Ext = sys::path::extension(It->path());
+    if (Ext!=".dot" && !Ext.startswith(".tmp"))
+      continue;
+    sys::fs::file_status Status;
+    if (sys::fs::status(It->path(), Status) ||
+        !sys::fs::is_regular_file(Status))
+      continue;
+    if (Status.getLastModificationTime()<Limit &&
+        !sys::fs::remove(It->path()))
+      Removed++;
+  }
+  return Removed;
+}
+
+}
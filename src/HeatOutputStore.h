@@ -0,0 +1,81 @@
+//===-- HeatOutputStore.h - Content-addressed output store ------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a local content-addressed store of heat output files.
+// Each output is keyed by a hash of everything it depends on: the IR of the
+// function, its frequencies, the printing options and the maximum frequency
+// used for scaling. When the key is already in the store, the stored file is
+// hard linked into the output directory instead of being generated again, so
+// repeated runs on identical inputs do almost no I/O. Since the output files
+// then share their contents with the store, every writer removes an existing
+// output file before writing it again instead of truncating it.
+//
+// Stored files are touched when reused, and the files that have not been
+// used for a given age are removed by the garbage collection.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATOUTPUTSTORE_H
+#define LLVM_ANALYSIS_HEATOUTPUTSTORE_H
+
+#include "HeatProfile.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/Function.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <string>
+
+using namespace llvm;
+
+namespace llvm {
+
+class HeatOutputStore {
+public:
+  explicit HeatOutputStore(StringRef Dir) : Dir(Dir) {}
+
+  StringRef getDirectory() const { return Dir; }
+
+  /// Returns the key of the inputs of \p F, hashing the structure of its IR
+  /// and its metadata, including the profile metadata, but not anything
+  /// numbered across the module. Functions with the same input key have the
+  /// same frequencies. It takes time linear in the size of \p F.
+  static std::string getFunctionInputKey(const Function &F);
+
+  /// Returns the key of an output of \p F, hashing its input key, its
+  /// frequencies in \p HP, the printing \p Options and the maximum
+  /// frequency.
+  static std::string getFunctionKey(const Function &F, const HeatProfile &HP,
+                                    StringRef Options, uint64_t MaxFreq);
+
+  /// Links the file stored with \p Key to \p Filename. Returns false if the
+  /// key is not in the store.
+  bool link(StringRef Key, StringRef Filename);
+
+  /// Stores the output written by \p Write with \p Key, and links it to
+  /// \p Filename.
+  bool store(StringRef Key, StringRef Filename,
+             function_ref<void(raw_ostream &)> Write);
+
+  /// Removes the stored files not used for \p MaxAge, and the temporary
+  /// files of interrupted stores older than that. Returns the number of
+  /// files removed.
+  unsigned collectGarbage(std::chrono::seconds MaxAge);
+
+private:
+  std::string getObjectPath(StringRef Key) const;
+
+  std::string Dir;
+};
+
+}
+
+#endif
@@ -0,0 +1,239 @@
+
+#include "HeatPagination.h"
+#include "HeatUtils.h"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/GraphWriter.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <utility>
+
+namespace llvm {
+
+static const unsigned NoPage = ~0u;
+
+std::vector<unsigned> partitionHeatGraph(const HeatPageGraph &G,
+                                         unsigned PageSize){
+  unsigned NumNodes = G.Nodes.size();
+  std::vector<unsigned> Page(NumNodes,NoPage);
+  if (PageSize==0)
+    PageSize = 1;
+
+  // Undirected adjacency lists in compressed form. Cold edges still get a
+  // unit weight, so that connected nodes are preferred over unrelated ones.
+  std::vector<unsigned> AdjBegin(NumNodes+1,0);
+  for (const HeatPageGraph::Edge &E : G.Edges) {
+    AdjBegin[E.Src+1]++;
+    AdjBegin[E.Dst+1]++;
+  }
+  for (unsigned N = 0; N<NumNodes; N++)
+    AdjBegin[N+1] += AdjBegin[N];
+  std::vector<std::pair<unsigned, uint64_t>> Adj(AdjBegin[NumNodes]);
+  std::vector<unsigned> AdjEnd(AdjBegin.begin(), AdjBegin.end()-1);
+  for (const HeatPageGraph::Edge &E : G.Edges) {
+    Adj[AdjEnd[E.Src]++] = std::make_pair(E.Dst,E.Freq+1);
+    Adj[AdjEnd[E.Dst]++] = std::make_pair(E.Src,E.Freq+1);
+  }
+
+  std::vector<unsigned> Order(NumNodes);
+  for (unsigned N = 0; N<NumNodes; N++)
+    Order[N] = N;
+  std::stable_sort(Order.begin(), Order.end(), [&G](unsigned A, unsigned B) {
+    return G.Nodes[A].Freq>G.Nodes[B].Freq;
+  });
+
+  // Gain of a node is the total weight of its edges into the current page.
+  // The heap may hold stale entries, which are skipped when popped.
+  std::vector<uint64_t> Gain(NumNodes,0);
+  std::vector<unsigned> Touched;
+  typedef std::pair<uint64_t, unsigned> HeapEntry;
+  unsigned NumPages = 0;
+  unsigned Next = 0;
+  auto FindSeed = [&]() {
+    while (Next<NumNodes && Page[Order[Next]]!=NoPage)
+      Next++;
+    return Next<NumNodes;
+  };
+  while (FindSeed()) {
+    unsigned P = NumPages++;
+    std::priority_queue<HeapEntry> Heap;
+    unsigned Size = 0;
+    while (Size<PageSize) {
+      // When no unassigned node is connected to the page, it is filled from
+      // the next hottest one rather than left partly empty.
+      if (Heap.empty()) {
+        if (!FindSeed())
+          break;
+        Heap.push(HeapEntry(0,Order[Next]));
+      }
+      HeapEntry Top = Heap.top();
+      Heap.pop();
+      unsigned N = Top.second;
+      if (Page[N]!=NoPage || Top.first!=Gain[N])
+        continue;
+      Page[N] = P;
+      Size++;
+      for (unsigned i = AdjBegin[N]; i<AdjBegin[N+1]; i++) {
+        unsigned M = Adj[i].first;
+        if (Page[M]!=NoPage)
+          continue;
+        if (Gain[M]==0)
+          Touched.push_back(M);
+        Gain[M] += Adj[i].second;
+        Heap.push(HeapEntry(Gain[M],M));
+      }
+    }
+    for (unsigned N : Touched)
+      Gain[N] = 0;
+    Touched.clear();
+  }
+  return Page;
+}
+
+static std::string getPageFilename(StringRef Prefix, unsigned P){
+  return (Prefix + ".page" + std::to_string(P) + ".dot").str();
+}
+
+static void writeNode(raw_ostream &OS, const HeatPageGraph &G, unsigned N){
+  const HeatPageGraph::Node &Node = G.Nodes[N];
+  OS << "\tn" << N << " [";
+  if (G.RecordNodes)
+    OS << "shape=record,label=\"{" << DOT::EscapeString(Node.Label) << "}\"";
+  else
+    OS << "label=\"" << DOT::EscapeString(Node.Label) << "\"";
+  if (!Node.Attrs.empty())
+    OS << "," << Node.Attrs;
+  OS << "];\n";
+}
+
+static void writeStub(raw_ostream &OS, const HeatPageGraph &G, unsigned N,
+                      unsigned P, StringRef Prefix){
+  const HeatPageGraph::Node &Node = G.Nodes[N];
+  OS << "\ts" << N << " [shape=box,style=\"dashed,filled\",label=\""
+     << DOT::EscapeString(Node.Name + " (page " + std::to_string(P) + ")")
+     << "\",fillcolor=\"" << getHeatColor(Node.Freq,G.MaxFreq)
+     << "80\",URL=\"" << sys::path::filename(getPageFilename(Prefix,P))
+     << "\"];\n";
+}
+
+static void writeEdge(raw_ostream &OS, StringRef Src, StringRef Dst,
+                      StringRef Attrs){
+  OS << "\t" << Src << " -> " << Dst;
+  if (!Attrs.empty())
+    OS << "[" << Attrs << "]";
+  OS << ";\n";
+}
+
+static bool writePage(const HeatPageGraph &G, ArrayRef<unsigned> Page,
+                      ArrayRef<unsigned> Nodes, ArrayRef<unsigned> Edges,
+                      unsigned P, StringRef Prefix){
+  std::string Filename = getPageFilename(Prefix,P);
+  std::error_code EC;
+  raw_fd_ostream File(Filename, EC, sys::fs::F_Text);
+  if (EC) {
+    HeatLog() << "Error opening '" << Filename << "' for writing!\n";
+    return false;
+  }
+
+  std::string Title = G.Title + " (page " + std::to_string(P) + ")";
+  File << "digraph \"" << DOT::EscapeString(Title) << "\" {\n";
+  File << "\tlabel=\"" << DOT::EscapeString(Title) << "\";\n\n";
+
+  for (unsigned N : Nodes)
+    writeNode(File,G,N);
+
+  std::vector<bool> Stubbed(G.Nodes.size(),false);
+  for (unsigned EI : Edges) {
+    const HeatPageGraph::Edge &E = G.Edges[EI];
+    std::string Src = "n" + std::to_string(E.Src);
+    std::string Dst = "n" + std::to_string(E.Dst);
+    if (Page[E.Src]!=P) {
+      if (!Stubbed[E.Src])
+        writeStub(File,G,E.Src,Page[E.Src],Prefix);
+      Stubbed[E.Src] = true;
+      Src = "s" + std::to_string(E.Src);
+    } else if (Page[E.Dst]!=P) {
+      if (!Stubbed[E.Dst])
+        writeStub(File,G,E.Dst,Page[E.Dst],Prefix);
+      Stubbed[E.Dst] = true;
+      Dst = "s" + std::to_string(E.Dst);
+    }
+    writeEdge(File,Src,Dst,E.Attrs);
+  }
+  File << "}\n";
+  return true;
+}
+
+static void writeIndex(const HeatPageGraph &G, ArrayRef<unsigned> Page,
+                       ArrayRef<std::vector<unsigned>> PageNodes,
+                       StringRef Prefix){
+  HeatLog Log;
+  std::string Filename = (Prefix + ".index.dot").str();
+  Log << "Writing '" << Filename << "'...";
+
+  std::error_code EC;
+  raw_fd_ostream File(Filename, EC, sys::fs::F_Text);
+  if (EC) {
+    Log << "  error opening file for writing!\n";
+    return;
+  }
+
+  std::string Title = G.Title + " (index)";
+  File << "digraph \"" << DOT::EscapeString(Title) << "\" {\n";
+  File << "\tlabel=\"" << DOT::EscapeString(Title) << "\";\n\n";
+
+  for (unsigned P = 0; P<PageNodes.size(); P++) {
+    uint64_t PageMaxFreq = 0;
+    for (unsigned N : PageNodes[P])
+      PageMaxFreq = std::max(PageMaxFreq,G.Nodes[N].Freq);
+    File << "\tp" << P << " [shape=box,style=filled,label=\"page " << P
+         << "\\n" << PageNodes[P].size() << " nodes\\nmax freq "
+         << PageMaxFreq << "\",fillcolor=\""
+         << getHeatColor(PageMaxFreq,G.MaxFreq) << "80\",URL=\""
+         << sys::path::filename(getPageFilename(Prefix,P)) << "\"];\n";
+  }
+
+  std::map<std::pair<unsigned, unsigned>, uint64_t> CutFreq;
+  for (const HeatPageGraph::Edge &E : G.Edges)
+    if (Page[E.Src]!=Page[E.Dst])
+      CutFreq[std::make_pair(Page[E.Src],Page[E.Dst])] += E.Freq;
+  for (auto &Cut : CutFreq)
+    File << "\tp" << Cut.first.first << " -> p" << Cut.first.second
+         << "[label=\"" << Cut.second << "\"];\n";
+  File << "}\n";
+  Log << "\n";
+}
+
+unsigned writeHeatGraphPages(const HeatPageGraph &G, unsigned PageSize,
+                             StringRef Prefix){
+  std::vector<unsigned> Page = partitionHeatGraph(G,PageSize);
+
+  unsigned NumPages = 0;
+  for (unsigned P : Page)
+    NumPages = std::max(NumPages,P+1);
+
+  std::vector<std::vector<unsigned>> PageNodes(NumPages);
+  for (unsigned N = 0; N<Page.size(); N++)
+    PageNodes[Page[N]].push_back(N);
+
+  // A cut edge is written in the pages of both of its ends.
+  std::vector<std::vector<unsigned>> PageEdges(NumPages);
+  for (unsigned EI = 0; EI<G.Edges.size(); EI++) {
+    const HeatPageGraph::Edge &E = G.Edges[EI];
+    PageEdges[Page[E.Src]].push_back(EI);
+    if (Page[E.Dst]!=Page[E.Src])
+      PageEdges[Page[E.Dst]].push_back(EI);
+  }
+
+  HeatLog() << "Writing " << NumPages << " pages of '" << Prefix << "'...\n";
+  for (unsigned P = 0; P<NumPages; P++)
+    writePage(G,Page,PageNodes[P],PageEdges[P],P,Prefix);
+  writeIndex(G,Page,PageNodes,Prefix);
+  return NumPages;
+}
+
+}
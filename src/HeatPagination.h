@@ -0,0 +1,71 @@
+//===-- HeatPagination.h - Paginated heat graph output ----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the pagination of heat graphs that are too big to be
+// rendered as a single dot file. The graph is partitioned into pages with a
+// bounded number of nodes, trying to keep the hot edges inside the pages.
+// Each page is written as its own dot file, where the edges that cross pages
+// point to stub nodes linking to the other page, together with an index page
+// that summarizes the pages and the heat flowing between them.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATPAGINATION_H
+#define LLVM_ANALYSIS_HEATPAGINATION_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+/// A heat graph, with the dot labels and attributes already computed.
+struct HeatPageGraph {
+  struct Node {
+    /// Short name, used for the stubs in other pages.
+    std::string Name;
+    std::string Label;
+    std::string Attrs;
+    uint64_t Freq;
+  };
+
+  struct Edge {
+    unsigned Src;
+    unsigned Dst;
+    uint64_t Freq;
+    std::string Attrs;
+  };
+
+  std::string Title;
+  uint64_t MaxFreq = 0;
+  /// Use record shaped nodes, as the CFG printers do.
+  bool RecordNodes = false;
+  std::vector<Node> Nodes;
+  std::vector<Edge> Edges;
+};
+
+/// Assigns a page to every node, so that no page has more than \p PageSize
+/// nodes. Pages are grown from the hottest unassigned node, always adding the
+/// node with the hottest edges to the current page, or the hottest unassigned
+/// node if none is connected to it. Only the last page may be partly empty.
+std::vector<unsigned> partitionHeatGraph(const HeatPageGraph &G,
+                                         unsigned PageSize);
+
+/// Writes the pages to <Prefix>.page<N>.dot and the index to
+/// <Prefix>.index.dot. Returns the number of pages.
+unsigned writeHeatGraphPages(const HeatPageGraph &G, unsigned PageSize,
+                             StringRef Prefix);
+
+}
+
+#endif
@@ -0,0 +1,45 @@
+
+#include "HeatPrinterOptions.h"
+#include "HeatMemoryBudget.h"
+#include "HeatUtils.h"
+
+#include "llvm/Support/CommandLine.h"
+
+using namespace llvm;
+
+static cl::opt<bool>
+HeatUniqueOutput("heat-unique-output", cl::init(false), cl::Hidden,
+                 cl::desc("Insert a unique tag in the names of the files "
+                          "written for each module, e.g. in parallel LTO"));
+
+static cl::opt<unsigned>
+HeatApproxMinBlocks("heat-approx-min-blocks", cl::init(0), cl::Hidden,
+                    cl::desc("Estimate the frequencies of the functions with "
+                             "at least this many blocks in linear time "
+                             "instead of with BFI (0 to disable)"));
+
+// The budget is shared by all the heat passes of the process, so the option
+// is stored in it directly.
+static cl::opt<unsigned, true>
+HeatMemoryBudgetMB("heat-memory-budget", cl::Hidden,
+                   cl::location(HeatMemoryBudget::instance().LimitMB),
+                   cl::desc("Keep the memory of the heat data and output "
+                            "buffers within this many MB (0 for no limit)"));
+
+namespace llvm {
+
+bool useUniqueHeatOutput(){
+  return HeatUniqueOutput;
+}
+
+std::string getHeatOutputTag(){
+  return HeatUniqueOutput?getUniqueHeatOutputTag():std::string();
+}
+
+HeatProfileOptions getHeatProfileOptions(){
+  HeatProfileOptions Opts;
+  Opts.ApproxMinBlocks = HeatApproxMinBlocks;
+  return Opts;
+}
+
+}
@@ -0,0 +1,37 @@
+//===-- HeatPrinterOptions.h - Options shared by heat passes ----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the command line options shared by all the heat passes.
+// The -heat-memory-budget option is stored in HeatMemoryBudget itself.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATPRINTEROPTIONS_H
+#define LLVM_ANALYSIS_HEATPRINTEROPTIONS_H
+
+#include "HeatProfile.h"
+
+#include <string>
+
+namespace llvm {
+
+/// Returns true with -heat-unique-output, when the names of the files written
+/// for a module have a tag unique to each run of a pass on it.
+bool useUniqueHeatOutput();
+
+/// Returns a new unique tag with -heat-unique-output, and an empty tag
+/// otherwise.
+std::string getHeatOutputTag();
+
+/// Returns the options of the heat data given on the command line.
+HeatProfileOptions getHeatProfileOptions();
+
+}
+
+#endif
@@ -0,0 +1,187 @@
+
+#include "HeatProfile.h"
+#include "HeatApproxFrequency.h"
+#include "HeatUtils.h"
+
+#include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Instructions.h"
+
+#include <memory>
+
+namespace llvm {
+
+HeatProfile::HeatProfile(Module &M,
+              function_ref<BlockFrequencyInfo *(Function &)> LookupBFI,
+              const HeatProfileOptions &Opts){
+  this->M = &M;
+  HasProfiling = llvm::hasProfiling(M);
+  MaxFreq = 0;
+
+  bool useHeuristic = !HasProfiling;
+
+  for (Function &F : M) {
+    if (F.isDeclaration())
+      continue;
+    if (Opts.Filter && !Opts.Filter(F))
+      continue;
+
+    unsigned FI = Functions.size();
+    FuncIndex[&F] = FI;
+    Functions.push_back(&F);
+    BlockBegin.push_back(Blocks.size());
+    CallBegin.push_back(CallSites.size());
+
+    uint64_t entryCount = 0;
+    Optional< uint64_t > count = F.getEntryCount();
+    if (count.hasValue())
+      entryCount = count.getValue();
+    FuncEntryCount.push_back(entryCount);
+
+    BlockFrequencyInfo *BFI = nullptr;
+    std::unique_ptr<HeatApproxFrequency> Approx;
+    const BranchProbabilityInfo *BPI;
+    if (Opts.ApproxMinBlocks && F.size()>=Opts.ApproxMinBlocks) {
+      Approx.reset(new HeatApproxFrequency(F));
+      BPI = &Approx->getBPI();
+    } else {
+      BFI = LookupBFI(F);
+      BPI = BFI->getBPI();
+    }
+
+    uint64_t localMaxFreq = 0;
+    for (BasicBlock &BB : F) {
+      uint64_t freq;
+      if (!Approx)
+        freq = llvm::getBlockFreq(&BB,BFI,useHeuristic);
+      else if (useHeuristic)
+        freq = Approx->getBlockFreq(&BB);
+      else
+        freq = Approx->getBlockProfileCount(&BB);
+      if (freq>=localMaxFreq)
+        localMaxFreq = freq;
+
+      BlockIndex[&BB] = Blocks.size();
+      Blocks.push_back(&BB);
+      BlockFreq.push_back(freq);
+
+      EdgeBegin.push_back(EdgeFreq.size());
+      unsigned SuccIdx = 0;
+      for (succ_iterator SI = succ_begin(&BB), SE = succ_end(&BB); SI!=SE;
+           ++SI, ++SuccIdx) {
+        uint64_t edgeFreq = 0;
+        if (BPI)
+          edgeFreq = BPI->getEdgeProbability(&BB,SuccIdx).scale(freq);
+        EdgeFreq.push_back(edgeFreq);
+      }
+
+      for (Instruction &I : BB) {
+        CallSite CS(&I);
+        if (!CS)
+          continue;
+        HeatCallSite Call;
+        Call.Call = &I;
+        Call.Callee = CS.getCalledFunction();
+        Call.Caller = FI;
+        Call.Freq = freq;
+        CallSites.push_back(Call);
+        if (Call.Callee)
+          NumOfCalls[std::make_pair(&F,Call.Callee)] += freq;
+      }
+    }
+
+    FuncMaxFreq.push_back(localMaxFreq);
+    if (localMaxFreq>=MaxFreq)
+      MaxFreq = localMaxFreq;
+  }
+
+  BlockBegin.push_back(Blocks.size());
+  EdgeBegin.push_back(EdgeFreq.size());
+  CallBegin.push_back(CallSites.size());
+}
+
+int HeatProfile::getFunctionIndex(const Function *F) const {
+  auto It = FuncIndex.find(F);
+  if (It==FuncIndex.end())
+    return -1;
+  return It->second;
+}
+
+uint64_t HeatProfile::getFunctionMaxFreq(const Function *F) const {
+  int FI = getFunctionIndex(F);
+  return (FI<0)?0:FuncMaxFreq[FI];
+}
+
+ArrayRef<const BasicBlock *> HeatProfile::blocks(unsigned FI) const {
+  return makeArrayRef(Blocks).slice(BlockBegin[FI],
+                                    BlockBegin[FI+1]-BlockBegin[FI]);
+}
+
+ArrayRef<uint64_t> HeatProfile::blockFreqs(unsigned FI) const {
+  return makeArrayRef(BlockFreq).slice(BlockBegin[FI],
+                                       BlockBegin[FI+1]-BlockBegin[FI]);
+}
+
+int HeatProfile::getBlockIndex(const BasicBlock *BB) const {
+  auto It = BlockIndex.find(BB);
+  if (It==BlockIndex.end())
+    return -1;
+  return It->second;
+}
+
+uint64_t HeatProfile::getBlockFreq(const BasicBlock *BB) const {
+  int BI = getBlockIndex(BB);
+  return (BI<0)?0:BlockFreq[BI];
+}
+
+ArrayRef<uint64_t> HeatProfile::edgeFreqs(unsigned BI) const {
+  return makeArrayRef(EdgeFreq).slice(EdgeBegin[BI],
+                                      EdgeBegin[BI+1]-EdgeBegin[BI]);
+}
+
+uint64_t HeatProfile::getEdgeFreq(const BasicBlock *BB,
+                                  unsigned SuccIdx) const {
+  int BI = getBlockIndex(BB);
+  if (BI<0)
+    return 0;
+  ArrayRef<uint64_t> Freqs = edgeFreqs(BI);
+  return (SuccIdx<Freqs.size())?Freqs[SuccIdx]:0;
+}
+
+ArrayRef<HeatCallSite> HeatProfile::callSites(unsigned FI) const {
+  return makeArrayRef(CallSites).slice(CallBegin[FI],
+                                       CallBegin[FI+1]-CallBegin[FI]);
+}
+
+uint64_t HeatProfile::getNumOfCalls(const Function *Caller,
+                                    const Function *Callee) const {
+  auto It = NumOfCalls.find(std::make_pair(Caller,Callee));
+  return (It==NumOfCalls.end())?0:It->second;
+}
+
+template <typename T>
+static size_t getVectorMemorySize(const std::vector<T> &V){
+  return V.capacity()*sizeof(T);
+}
+
+size_t HeatProfile::getMemorySize() const {
+  return sizeof(*this) + getVectorMemorySize(Functions) +
+         FuncIndex.getMemorySize() + getVectorMemorySize(FuncMaxFreq) +
+         getVectorMemorySize(FuncEntryCount) +
+         getVectorMemorySize(BlockBegin) + getVectorMemorySize(Blocks) +
+         getVectorMemorySize(BlockFreq) + BlockIndex.getMemorySize() +
+         getVectorMemorySize(EdgeBegin) + getVectorMemorySize(EdgeFreq) +
+         getVectorMemorySize(CallBegin) + getVectorMemorySize(CallSites) +
+         NumOfCalls.getMemorySize();
+}
+
+double HeatProfile::getHeat(uint64_t Freq, uint64_t MaxFreq){
+  if (MaxFreq==0)
+    return 0.0;
+  if (Freq>MaxFreq)
+    return 1.0;
+  return double(Freq)/double(MaxFreq);
+}
+
+}
@@ -0,0 +1,154 @@
+//===-- HeatProfile.h - Heat data of a module -------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the HeatProfile class, the embeddable heat analysis API.
+// A HeatProfile is computed once from a module and a block frequency lookup
+// callback, and stores the per-function, per-block, per-edge and per-call-site
+// frequencies in dense arrays. Blocks, edges and call sites of a function are
+// contiguous, so they can be iterated as ArrayRefs.
+//
+// Frequencies are profile counts when the module has profiling annotations,
+// otherwise they are the heuristic block frequencies estimated by BFI.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATPROFILE_H
+#define LLVM_ANALYSIS_HEATPROFILE_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+/// A direct or indirect call site of a defined function.
+struct HeatCallSite {
+  const Instruction *Call;
+  /// Called function, or null for indirect calls.
+  const Function *Callee;
+  /// Index of the calling function in the profile.
+  unsigned Caller;
+  /// Frequency of the block containing the call.
+  uint64_t Freq;
+};
+
+struct HeatProfileOptions {
+  /// If set, only the defined functions for which it returns true are part
+  /// of the profile, and the frequencies of the others are never computed.
+  std::function<bool(const Function &)> Filter;
+  /// If not 0, the frequencies of the functions with at least this many
+  /// blocks are estimated by HeatApproxFrequency, in linear time, instead of
+  /// by BFI, which is then never looked up for them.
+  unsigned ApproxMinBlocks = 0;
+};
+
+class HeatProfile {
+public:
+  HeatProfile(Module &M,
+              function_ref<BlockFrequencyInfo *(Function &)> LookupBFI,
+              const HeatProfileOptions &Opts = HeatProfileOptions());
+
+  Module &getModule() const { return *M; }
+
+  /// Returns true if the frequencies are profile counts.
+  bool hasProfiling() const { return HasProfiling; }
+
+  /// Maximum block frequency of the whole module.
+  uint64_t getMaxFreq() const { return MaxFreq; }
+
+  /// Defined functions, in module order. Declarations and functions
+  /// excluded by the filter are not included.
+  unsigned getNumFunctions() const { return Functions.size(); }
+  ArrayRef<Function *> functions() const { return Functions; }
+  Function *getFunction(unsigned FI) const { return Functions[FI]; }
+
+  /// Returns the index of \p F, or -1 if it is not a defined function.
+  int getFunctionIndex(const Function *F) const;
+
+  uint64_t getFunctionMaxFreq(unsigned FI) const { return FuncMaxFreq[FI]; }
+  uint64_t getFunctionMaxFreq(const Function *F) const;
+
+  /// Profiled entry count of the function, or 0 if unknown.
+  uint64_t getFunctionEntryCount(unsigned FI) const {
+    return FuncEntryCount[FI];
+  }
+
+  /// Per-function maximum frequencies, indexed by function index.
+  ArrayRef<uint64_t> functionMaxFreqs() const { return FuncMaxFreq; }
+
+  /// Blocks and their frequencies, over all functions or a single one.
+  /// Block indices are global, blocks of a function are contiguous.
+  unsigned getNumBlocks() const { return Blocks.size(); }
+  ArrayRef<const BasicBlock *> blocks() const { return Blocks; }
+  ArrayRef<const BasicBlock *> blocks(unsigned FI) const;
+  ArrayRef<uint64_t> blockFreqs() const { return BlockFreq; }
+  ArrayRef<uint64_t> blockFreqs(unsigned FI) const;
+  unsigned getFirstBlock(unsigned FI) const { return BlockBegin[FI]; }
+
+  /// Returns the global index of \p BB, or -1 if it is not in the profile.
+  int getBlockIndex(const BasicBlock *BB) const;
+
+  uint64_t getBlockFreq(unsigned BI) const { return BlockFreq[BI]; }
+  uint64_t getBlockFreq(const BasicBlock *BB) const;
+
+  /// Frequencies of the outgoing edges of a block, in successor order.
+  ArrayRef<uint64_t> edgeFreqs(unsigned BI) const;
+  uint64_t getEdgeFreq(const BasicBlock *BB, unsigned SuccIdx) const;
+
+  /// Call sites, over all functions or those of a single calling function.
+  ArrayRef<HeatCallSite> callSites() const { return CallSites; }
+  ArrayRef<HeatCallSite> callSites(unsigned FI) const;
+
+  /// Number of calls from \p Caller to \p Callee, i.e. the sum of the
+  /// frequencies of the call sites.
+  uint64_t getNumOfCalls(const Function *Caller, const Function *Callee) const;
+
+  /// Heat of a frequency in [0,1], relative to the module maximum.
+  double getHeat(uint64_t Freq) const { return getHeat(Freq, MaxFreq); }
+  static double getHeat(uint64_t Freq, uint64_t MaxFreq);
+
+  /// Number of bytes held by the profile, not counting the module.
+  size_t getMemorySize() const;
+
+private:
+  Module *M;
+  bool HasProfiling;
+  uint64_t MaxFreq;
+
+  std::vector<Function *> Functions;
+  DenseMap<const Function *, unsigned> FuncIndex;
+  std::vector<uint64_t> FuncMaxFreq;
+  std::vector<uint64_t> FuncEntryCount;
+
+  std::vector<unsigned> BlockBegin;
+  std::vector<const BasicBlock *> Blocks;
+  std::vector<uint64_t> BlockFreq;
+  DenseMap<const BasicBlock *, unsigned> BlockIndex;
+
+  std::vector<unsigned> EdgeBegin;
+  std::vector<uint64_t> EdgeFreq;
+
+  std::vector<unsigned> CallBegin;
+  std::vector<HeatCallSite> CallSites;
+  DenseMap<std::pair<const Function *, const Function *>, uint64_t> NumOfCalls;
+};
+
+}
+
+#endif
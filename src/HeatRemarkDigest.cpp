@@ -0,0 +1,219 @@
+
+#include "HeatRemarkDigest.h"
+#include "HeatProfile.h"
+
+#include "llvm/Support/Format.h"
+
+#include <algorithm>
+
+namespace llvm {
+
+static StringRef unquote(StringRef Value){
+  Value = Value.trim();
+  if (Value.size()>=2 && (Value.front()=='\'' || Value.front()=='"') &&
+      Value.back()==Value.front())
+    return Value.drop_front().drop_back();
+  return Value;
+}
+
+/// Appends the scalar \p Value, with the escapes of its quotes undone.
+static void appendScalar(std::string &Str, StringRef Value){
+  Value = Value.trim();
+  char Quote = Value.empty()?0:Value.front();
+  Value = unquote(Value);
+  if (Quote!='\'') {
+    Str += Value;
+    return;
+  }
+  for (unsigned i = 0; i<Value.size(); i++) {
+    Str += Value[i];
+    if (Value[i]=='\'' && i+1<Value.size() && Value[i+1]=='\'')
+      i++;
+  }
+}
+
+/// Returns the value of \p Key in the flow mapping \p Map, such as
+/// "{ File: a.c, Line: 3, Column: 7 }".
+static StringRef getFlowValue(StringRef Map, StringRef Key){
+  Map = Map.trim().drop_front().drop_back();
+  while (!Map.empty()) {
+    std::pair<StringRef, StringRef> Item = Map.split(',');
+    std::pair<StringRef, StringRef> KV = Item.first.split(':');
+    if (KV.first.trim()==Key)
+      return unquote(KV.second);
+    Map = Item.second;
+  }
+  return StringRef();
+}
+
+bool HeatRemark::parse(StringRef Text, HeatRemark &R){
+  R = HeatRemark();
+  R.Text = Text;
+  bool InArgs = false;
+  while (!Text.empty()) {
+    std::pair<StringRef, StringRef> Split = Text.split('\n');
+    StringRef Line = Split.first.rtrim();
+    Text = Split.second;
+
+    if (Line.startswith("---")) {
+      R.Kind = Line.drop_front(3).trim();
+      continue;
+    }
+    if (Line.startswith("  - ")) {
+      // An argument, whose value may be followed by its location on the next
+      // lines.
+      std::pair<StringRef, StringRef> KV = Line.drop_front(4).split(':');
+      if (InArgs)
+        appendScalar(R.Message,KV.second);
+      continue;
+    }
+    if (Line.empty() || Line.front()==' ' || Line=="...")
+      continue;
+
+    std::pair<StringRef, StringRef> KV = Line.split(':');
+    StringRef Key = KV.first;
+    StringRef Value = KV.second.trim();
+    InArgs = (Key=="Args");
+    if (Key=="Pass")
+      R.Pass = unquote(Value);
+    else if (Key=="Name")
+      R.Name = unquote(Value);
+    else if (Key=="Function")
+      R.Function = unquote(Value);
+    else if (Key=="Hotness") {
+      uint64_t Hotness;
+      if (!Value.getAsInteger(10,Hotness))
+        R.Hotness = Hotness;
+    } else if (Key=="DebugLoc" && Value.startswith("{")) {
+      R.Location = (getFlowValue(Value,"File") + ":" +
+                    getFlowValue(Value,"Line") + ":" +
+                    getFlowValue(Value,"Column")).str();
+    }
+  }
+  return !R.Kind.empty() && !R.Function.empty();
+}
+
+HeatRemarkReader::HeatRemarkReader(const MemoryBuffer &Buffer)
+    : Rest(Buffer.getBuffer()) {}
+
+bool HeatRemarkReader::next(HeatRemark &R){
+  while (!Rest.empty()) {
+    // Skip to the start of the next document.
+    std::pair<StringRef, StringRef> Line = Rest.split('\n');
+    Rest = Line.second;
+    if (!Line.first.startswith("---"))
+      continue;
+    const char *Begin = Line.first.begin();
+    const char *End = Line.first.end();
+    while (!Rest.empty()) {
+      Line = Rest.split('\n');
+      if (Line.first.startswith("---"))
+        break;
+      Rest = Line.second;
+      End = Line.first.end();
+      if (Line.first.rtrim()=="...")
+        break;
+    }
+    if (HeatRemark::parse(StringRef(Begin, End-Begin), R))
+      return true;
+  }
+  return false;
+}
+
+HeatRemarkDigest::HeatRemarkDigest(ArrayRef<HeatSummary> Summaries,
+                                   double MinHeat, unsigned MaxRemarks)
+    : MinHeat(MinHeat), MaxRemarks(MaxRemarks) {
+  for (const HeatSummary &Summary : Summaries) {
+    MaxFreq = std::max(MaxFreq,Summary.MaxFreq);
+    HasProfiling &= Summary.HasProfiling;
+    for (auto &Entry : Summary.FunctionMaxFreq) {
+      uint64_t &Freq = FunctionMaxFreq[Entry.first];
+      Freq = std::max(Freq,Entry.second);
+    }
+  }
+}
+
+bool HeatRemarkDigest::isHotter(const Entry &A, const Entry &B){
+  if (A.Heat!=B.Heat)
+    return A.Heat>B.Heat;
+  return A.Seq<B.Seq;
+}
+
+void HeatRemarkDigest::add(const HeatRemark &R){
+  uint64_t Seq = NumRemarks++;
+  if (R.Kind!="!Missed")
+    return;
+  NumMissed++;
+
+  // The hotness of a remark is a profile count, comparable to the summary
+  // only if it was built from a profile as well. Otherwise, the remark takes
+  // the heat of its function.
+  double Heat;
+  if (R.Hotness && HasProfiling) {
+    Heat = HeatProfile::getHeat(*R.Hotness,MaxFreq);
+  } else {
+    auto It = FunctionMaxFreq.find(R.Function);
+    if (It==FunctionMaxFreq.end()) {
+      NumUnknown++;
+      return;
+    }
+    Heat = HeatProfile::getHeat(It->second,MaxFreq);
+  }
+  if (Heat<MinHeat)
+    return;
+  NumHot++;
+
+  if (MaxRemarks==0)
+    return;
+  Entry E = {Heat, Seq, std::string()};
+  if (Heap.size()==MaxRemarks) {
+    if (!isHotter(E,Heap.front()))
+      return;
+    std::pop_heap(Heap.begin(), Heap.end(), isHotter);
+    Heap.pop_back();
+  }
+  E.Text = R.Text.str();
+  Heap.push_back(std::move(E));
+  std::push_heap(Heap.begin(), Heap.end(), isHotter);
+}
+
+std::vector<HeatRemarkDigest::Entry> HeatRemarkDigest::getSorted() const {
+  std::vector<Entry> Sorted(Heap);
+  std::sort(Sorted.begin(), Sorted.end(), isHotter);
+  return Sorted;
+}
+
+void HeatRemarkDigest::print(raw_ostream &OS) const {
+  OS << "# heat hotness function location pass name message\n";
+  for (const Entry &E : getSorted()) {
+    HeatRemark R;
+    HeatRemark::parse(E.Text,R);
+    OS << format("%.4f", E.Heat) << " ";
+    if (R.Hotness)
+      OS << *R.Hotness;
+    else
+      OS << "-";
+    OS << " " << R.Function << " "
+       << (R.Location.empty()?StringRef("-"):StringRef(R.Location)) << " "
+       << R.Pass << " " << R.Name << " " << R.Message << "\n";
+  }
+}
+
+void HeatRemarkDigest::writeYAML(raw_ostream &OS) const {
+  for (const Entry &E : getSorted()) {
+    OS << E.Text;
+    if (!StringRef(E.Text).endswith("..."))
+      OS << "\n...";
+    OS << "\n";
+  }
+}
+
+void HeatRemarkDigest::printStats(raw_ostream &OS) const {
+  OS << "Read " << NumRemarks << " remarks, " << NumMissed << " missed, "
+     << NumHot << " in hot code";
+  if (NumUnknown)
+    OS << ", " << NumUnknown << " in functions missing from the summaries";
+  OS << "\n";
+}
+
+}
@@ -0,0 +1,119 @@
+//===-- HeatRemarkDigest.h - Hot missed optimization remarks ----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the digest of the missed optimization remarks of a build
+// that are in hot code. The YAML remark files written by -pass-remarks-output
+// are read one document at a time, and the heat of each missed remark is
+// found from its hotness or from the heat summary of its function. Only the
+// hottest remarks are kept, so the memory used does not depend on the size
+// of the remark files.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATREMARKDIGEST_H
+#define LLVM_ANALYSIS_HEATREMARKDIGEST_H
+
+#include "HeatSummary.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+/// A remark document of a YAML remark file. The fields refer to the text of
+/// the document.
+struct HeatRemark {
+  /// Tag of the document, e.g. "!Missed".
+  StringRef Kind;
+  StringRef Pass;
+  StringRef Name;
+  StringRef Function;
+  /// "file:line:column", or empty if the remark has no location.
+  std::string Location;
+  Optional<uint64_t> Hotness;
+  /// Concatenation of the values of the arguments.
+  std::string Message;
+  /// Whole document, from its "---" line to its "..." line.
+  StringRef Text;
+
+  /// Parses the document \p Text. Returns false if it is not a remark.
+  static bool parse(StringRef Text, HeatRemark &R);
+};
+
+/// Splits a YAML remark file into documents without parsing it as a whole.
+/// Files are mapped rather than read, so their pages can be dropped by the
+/// system as the reader goes.
+class HeatRemarkReader {
+public:
+  /// The documents are split within the bounds of \p Buffer, which need
+  /// not be null terminated.
+  explicit HeatRemarkReader(const MemoryBuffer &Buffer);
+
+  /// Reads the next remark. Returns false at the end of the file.
+  bool next(HeatRemark &R);
+
+private:
+  /// Text of the buffer from the line read next.
+  StringRef Rest;
+};
+
+class HeatRemarkDigest {
+public:
+  /// Keeps the \p MaxRemarks hottest missed remarks with heat of at least
+  /// \p MinHeat. The heat is relative to the maximum frequency of the
+  /// \p Summaries, which may be those of several modules.
+  HeatRemarkDigest(ArrayRef<HeatSummary> Summaries, double MinHeat,
+                   unsigned MaxRemarks);
+
+  void add(const HeatRemark &R);
+
+  /// Prints the kept remarks by decreasing heat, one per line.
+  void print(raw_ostream &OS) const;
+
+  /// Writes the YAML documents of the kept remarks by decreasing heat, so
+  /// that they can be read by the remark viewers.
+  void writeYAML(raw_ostream &OS) const;
+
+  void printStats(raw_ostream &OS) const;
+
+private:
+  struct Entry {
+    double Heat;
+    uint64_t Seq;
+    std::string Text;
+  };
+  static bool isHotter(const Entry &A, const Entry &B);
+  std::vector<Entry> getSorted() const;
+
+  StringMap<uint64_t> FunctionMaxFreq;
+  uint64_t MaxFreq = 0;
+  bool HasProfiling = true;
+  double MinHeat;
+  unsigned MaxRemarks;
+  /// Min-heap of the kept remarks, by heat.
+  std::vector<Entry> Heap;
+
+  uint64_t NumRemarks = 0;
+  uint64_t NumMissed = 0;
+  uint64_t NumHot = 0;
+  uint64_t NumUnknown = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,69 @@
+//===-- HeatRemarkPrinter.cpp - Heat remark emitter -------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-remarks' analysis pass, which emits the heat of
+// the hot functions, loops and blocks as analysis remarks of the 'heat'
+// pass. The remarks are shown with -pass-remarks-analysis=heat and written
+// to the file of -pass-remarks-output, with the profile count of their code
+// region as hotness when the module has a profile.
+//===----------------------------------------------------------------------===//
+
+#include "HeatRemarkPrinter.h"
+#include "HeatPrinterOptions.h"
+#include "HeatRemarks.h"
+#include "HeatUtils.h"
+
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/OptimizationDiagnosticInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+
+
+static cl::opt<double>
+RemarksMinHeat("heat-remarks-min-heat", cl::init(0.1), cl::Hidden,
+               cl::desc("Minimum heat, in [0,1], of the functions, loops and "
+                        "blocks with a remark"));
+
+namespace {
+
+void HeatRemarkPrinterPass::getAnalysisUsage(AnalysisUsage &AU) const {
+  HeatReportPass::getAnalysisUsage(AU);
+  AU.addRequired<LoopInfoWrapperPass>();
+}
+
+bool HeatRemarkPrinterPass::runOnModule(Module &M) {
+  HeatProfile &HP = getHeatProfile(M,getHeatProfileOptions());
+  unsigned NumRemarks = 0;
+  for (unsigned FI = 0; FI<HP.getNumFunctions(); FI++) {
+    if (HP.getHeat(HP.getFunctionMaxFreq(FI))<RemarksMinHeat)
+      continue;
+    // Getting an analysis of a function recomputes all of them, so the
+    // BFI is taken last. Its profile counts give the hotness of the remarks.
+    Function &F = *HP.getFunction(FI);
+    const LoopInfo &LI = getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo();
+    OptimizationRemarkEmitter ORE(&F,LookupBFI(F));
+    NumRemarks += emitHeatRemarks(HP,FI,LI,ORE,RemarksMinHeat);
+  }
+  HeatLog() << "Emitted " << NumRemarks << " heat remarks of '"
+            << M.getModuleIdentifier() << "'\n";
+  return false;
+}
+
+}
+
+char HeatRemarkPrinterPass::ID = 0;
+static RegisterPass<HeatRemarkPrinterPass> X("heat-remarks",
+          "Emit the heat of hot code as optimization remarks.",
+          false, false);
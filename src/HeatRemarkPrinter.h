@@ -0,0 +1,38 @@
+//===-- HeatRemarkPrinter.h - Heat remark emitter ---------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-remarks' analysis pass, which emits the heat of
+// the hot functions, loops and blocks as optimization remarks.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATREMARKPRINTER_H
+#define LLVM_ANALYSIS_HEATREMARKPRINTER_H
+
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace {
+
+class HeatRemarkPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatRemarkPrinterPass() : HeatReportPass(ID) {}
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+  bool runOnModule(Module &M) override;
+};
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+
+#include "HeatRemarks.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/Instruction.h"
+
+#define DEBUG_TYPE "heat"
+
+namespace llvm {
+
+/// Returns the frequency of the edges entering \p L from outside of it.
+static uint64_t getLoopEntryFreq(const HeatProfile &HP, const Loop &L){
+  const BasicBlock *Header = L.getHeader();
+  uint64_t Freq = 0;
+  for (const BasicBlock *Pred : predecessors(Header)) {
+    if (L.contains(Pred))
+      continue;
+    unsigned SuccIdx = 0;
+    for (const BasicBlock *Succ : successors(Pred)) {
+      if (Succ==Header)
+        Freq += HP.getEdgeFreq(Pred,SuccIdx);
+      SuccIdx++;
+    }
+  }
+  return Freq;
+}
+
+/// Returns the first instruction of \p BB with a debug location, or its
+/// first instruction if it has none.
+static const Instruction *getLocatedInstruction(const BasicBlock &BB){
+  for (const Instruction &I : BB)
+    if (I.getDebugLoc())
+      return &I;
+  return &BB.front();
+}
+
+unsigned emitHeatRemarks(const HeatProfile &HP, unsigned FI,
+                         const LoopInfo &LI, OptimizationRemarkEmitter &ORE,
+                         double MinHeat){
+  uint64_t MaxFreq = HP.getMaxFreq();
+  uint64_t FuncMaxFreq = HP.getFunctionMaxFreq(FI);
+  if (HP.getHeat(FuncMaxFreq)<MinHeat)
+    return 0;
+
+  const Function &F = *HP.getFunction(FI);
+  const BasicBlock &Entry = F.getEntryBlock();
+  ORE.emit(OptimizationRemarkAnalysis(DEBUG_TYPE, "HotFunction",
+                                      getLocatedInstruction(Entry))
+           << "hot function: max frequency "
+           << ore::NV("MaxFrequency", FuncMaxFreq) << ", entry frequency "
+           << ore::NV("EntryFrequency", HP.getBlockFreq(&Entry))
+           << ", heat bucket "
+           << ore::NV("HeatBucket", getHeatBucket(FuncMaxFreq,MaxFreq)));
+  unsigned NumRemarks = 1;
+
+  for (const Loop *L : LI.getLoopsInPreorder()) {
+    uint64_t Freq = HP.getBlockFreq(L->getHeader());
+    if (HP.getHeat(Freq)<MinHeat)
+      continue;
+    uint64_t EntryFreq = getLoopEntryFreq(HP,*L);
+    ORE.emit(OptimizationRemarkAnalysis(DEBUG_TYPE, "HotLoop",
+                                        L->getStartLoc(), L->getHeader())
+             << "hot loop at depth " << ore::NV("Depth", L->getLoopDepth())
+             << ": header frequency " << ore::NV("Frequency", Freq)
+             << ", " << ore::NV("IterationsPerEntry",
+                                EntryFreq?Freq/EntryFreq:0)
+             << " iterations per entry, heat bucket "
+             << ore::NV("HeatBucket", getHeatBucket(Freq,MaxFreq)));
+    NumRemarks++;
+  }
+
+  ArrayRef<const BasicBlock *> Blocks = HP.blocks(FI);
+  ArrayRef<uint64_t> Freqs = HP.blockFreqs(FI);
+  for (unsigned i = 0; i<Blocks.size(); i++) {
+    if (HP.getHeat(Freqs[i])<MinHeat)
+      continue;
+    ORE.emit(OptimizationRemarkAnalysis(DEBUG_TYPE, "HotBlock",
+                                        getLocatedInstruction(*Blocks[i]))
+             << "hot block: frequency " << ore::NV("Frequency", Freqs[i])
+             << ", heat bucket "
+             << ore::NV("HeatBucket", getHeatBucket(Freqs[i],MaxFreq)));
+    NumRemarks++;
+  }
+  return NumRemarks;
+}
+
+}
@@ -0,0 +1,38 @@
+//===-- HeatRemarks.h - Heat optimization remarks ---------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the emission of the heat of hot functions, loops and
+// blocks as optimization analysis remarks of the 'heat' pass, so that they
+// are written to remark files by -pass-remarks-output and shown by the
+// existing remark viewers next to the remarks of the optimizations.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATREMARKS_H
+#define LLVM_ANALYSIS_HEATREMARKS_H
+
+#include "HeatProfile.h"
+
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/OptimizationDiagnosticInfo.h"
+
+using namespace llvm;
+
+namespace llvm {
+
+/// Emits a remark for the function \p FI of \p HP if its heat is at least
+/// \p MinHeat, and one for each of its loops and blocks with at least that
+/// heat. Returns the number of remarks emitted.
+unsigned emitHeatRemarks(const HeatProfile &HP, unsigned FI,
+                         const LoopInfo &LI, OptimizationRemarkEmitter &ORE,
+                         double MinHeat);
+
+}
+
+#endif
@@ -0,0 +1,38 @@
+
+#include "HeatReportPass.h"
+#include "HeatDataCache.h"
+#include "HeatMemoryBudget.h"
+
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace llvm {
+
+HeatReportPass::HeatReportPass(char &ID) : ModulePass(ID) {
+  LookupBFI = [this](Function &F) {
+    return &this->getAnalysis<BlockFrequencyInfoWrapperPass>(F).getBFI();
+  };
+}
+
+void HeatReportPass::getAnalysisUsage(AnalysisUsage &AU) const {
+  ModulePass::getAnalysisUsage(AU);
+  AU.addRequired<BlockFrequencyInfoWrapperPass>();
+  AU.setPreservesAll();
+}
+
+bool HeatReportPass::doFinalization(Module &M) {
+  HeatDataCache::instance().invalidate(M);
+  HeatMemoryBudget::instance().finalize();
+  return false;
+}
+
+HeatProfile &HeatReportPass::getHeatProfile(Module &M,
+                                            const HeatProfileOptions &Opts){
+  return HeatDataCache::instance().get(M,LookupBFI,Opts);
+}
+
+}
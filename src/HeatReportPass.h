@@ -0,0 +1,53 @@
+//===-- HeatReportPass.h - Base of the heat report passes -------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the base of the heat passes that write reports from the
+// heat data of a module. The passes require the frequencies of every function
+// and take the heat data from the data cache, so that it is computed once for
+// all of them. The data is dropped, and the memory peak reported, when the
+// passes are finalized.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATREPORTPASS_H
+#define LLVM_ANALYSIS_HEATREPORTPASS_H
+
+#include "HeatProfile.h"
+
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+#include <functional>
+
+using namespace llvm;
+
+namespace llvm {
+
+class HeatReportPass : public ModulePass {
+public:
+  explicit HeatReportPass(char &ID);
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+  bool doFinalization(Module &M) override;
+
+protected:
+  /// Returns the heat data of \p M computed with \p Opts, shared with the
+  /// other heat passes run on \p M.
+  HeatProfile &getHeatProfile(Module &M, const HeatProfileOptions &Opts);
+
+  /// Returns the frequencies of a function. Getting an analysis of a
+  /// function recomputes all of them, so it must be taken last.
+  std::function<BlockFrequencyInfo *(Function &)> LookupBFI;
+};
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+//===-- HeatSpecPrinter.cpp - Specialization printer ------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-specialization' analysis pass, which emits the
+// <module>.heatspecialization.txt report with the arguments that hot call
+// sites pass as constants or loop-invariant values, ranked by the benefit
+// that specializing their callees on them could have.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeatSpecPrinter.h"
+#include "HeatPrinterOptions.h"
+#include "HeatSpecialization.h"
+#include "HeatUtils.h"
+
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+
+static cl::opt<double>
+SpecMinHeat("heat-spec-min-heat", cl::init(0.01), cl::Hidden,
+            cl::desc("Minimum heat of the call sites considered for "
+                     "specialization"));
+
+static cl::opt<unsigned>
+SpecCandidates("heat-spec-candidates", cl::init(50), cl::Hidden,
+               cl::desc("Number of specialization candidates reported"));
+
+namespace {
+
+void HeatSpecPrinterPass::getAnalysisUsage(AnalysisUsage &AU) const {
+  HeatReportPass::getAnalysisUsage(AU);
+  AU.addRequired<LoopInfoWrapperPass>();
+}
+
+bool HeatSpecPrinterPass::runOnModule(Module &M) {
+  auto LookupLI = [this](Function &F) {
+    return &this->getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo();
+  };
+
+  HeatProfile &HP = getHeatProfile(M,getHeatProfileOptions());
+  std::vector<HeatSpecializationCandidate> Candidates =
+      findHeatSpecializationCandidates(HP,LookupLI,SpecMinHeat);
+
+  std::string Filename = getHeatOutputFilename(M.getModuleIdentifier(),
+                                               getHeatOutputTag(),
+                                               ".heatspecialization.txt");
+  writeHeatReport(Filename,[&](raw_ostream &OS) {
+    printHeatSpecializationCandidates(OS,Candidates,SpecCandidates);
+  });
+  return false;
+}
+
+}
+
+char HeatSpecPrinterPass::ID = 0;
+static RegisterPass<HeatSpecPrinterPass> X("heat-specialization",
+          "Print the function specialization candidates of the module.",
+          false, false);
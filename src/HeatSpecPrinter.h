@@ -0,0 +1,38 @@
+//===-- HeatSpecPrinter.h - Specialization printer --------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-specialization' analysis pass, which emits the
+// <module>.heatspecialization.txt report of specialization candidates.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATSPECPRINTER_H
+#define LLVM_ANALYSIS_HEATSPECPRINTER_H
+
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace {
+
+class HeatSpecPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatSpecPrinterPass() : HeatReportPass(ID) {}
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+  bool runOnModule(Module &M) override;
+};
+
+}
+
+#endif
@@ -0,0 +1,130 @@
+
+#include "HeatSpecialization.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Instructions.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+namespace llvm {
+
+/// Estimates the part of \p F that a known value of \p A may simplify: the
+/// instructions that transitively use it and, for the branches on it, the
+/// blocks they branch to, as some of them become dead.
+static unsigned getAffectedSize(const Argument &A){
+  SmallPtrSet<const Value *, 32> Visited;
+  SmallPtrSet<const BasicBlock *, 8> Branched;
+  SmallVector<const Value *, 32> Worklist;
+  Worklist.push_back(&A);
+  unsigned Size = 0;
+  while (!Worklist.empty()) {
+    const Value *V = Worklist.pop_back_val();
+    for (const User *U : V->users()) {
+      const Instruction *I = dyn_cast<Instruction>(U);
+      if (!I || !Visited.insert(I).second)
+        continue;
+      Size++;
+      if (isa<BranchInst>(I) || isa<SwitchInst>(I)) {
+        for (const BasicBlock *Succ : successors(I->getParent()))
+          if (Branched.insert(Succ).second)
+            Size += Succ->size();
+        continue;
+      }
+      // Values stored to memory are not followed.
+      if (!isa<StoreInst>(I))
+        Worklist.push_back(I);
+    }
+  }
+  return Size;
+}
+
+std::vector<HeatSpecializationCandidate>
+findHeatSpecializationCandidates(const HeatProfile &HP,
+                                 function_ref<LoopInfo *(Function &)> LookupLI,
+                                 double MinHeat){
+  typedef std::tuple<const Function *, unsigned, const Constant *> Key;
+  std::map<Key, unsigned> CandidateIndex;
+  std::vector<HeatSpecializationCandidate> Candidates;
+  DenseMap<const Argument *, unsigned> AffectedSize;
+
+  for (unsigned FI = 0; FI<HP.getNumFunctions(); FI++) {
+    LoopInfo *LI = nullptr;
+    for (const HeatCallSite &Call : HP.callSites(FI)) {
+      const Function *Callee = Call.Callee;
+      if (!Callee || HP.getFunctionIndex(Callee)<0 ||
+          HP.getHeat(Call.Freq)<MinHeat)
+        continue;
+      if (!LI)
+        LI = LookupLI(*HP.getFunction(FI));
+      const Loop *L = LI->getLoopFor(Call.Call->getParent());
+
+      ImmutableCallSite CS(Call.Call);
+      unsigned ArgNo = 0;
+      for (const Argument &Arg : Callee->args()) {
+        if (ArgNo>=CS.arg_size())
+          break;
+        const Value *V = CS.getArgument(ArgNo);
+        const Constant *C = dyn_cast<Constant>(V);
+        if (C && isa<UndefValue>(C))
+          C = nullptr;
+        if (C || (L && L->isLoopInvariant(V))) {
+          auto Size = AffectedSize.insert(std::make_pair(&Arg,0));
+          if (Size.second)
+            Size.first->second = getAffectedSize(Arg);
+
+          auto It = CandidateIndex.insert(
+              std::make_pair(Key(Callee,ArgNo,C),Candidates.size()));
+          if (It.second) {
+            HeatSpecializationCandidate New = {Callee, ArgNo, C, 0, 0,
+                                               Size.first->second, 0};
+            Candidates.push_back(New);
+          }
+          HeatSpecializationCandidate &Cand = Candidates[It.first->second];
+          Cand.Freq += Call.Freq;
+          Cand.NumCallSites++;
+        }
+        ArgNo++;
+      }
+    }
+  }
+
+  for (HeatSpecializationCandidate &Cand : Candidates)
+    Cand.Score = Cand.Freq*Cand.AffectedSize;
+  Candidates.erase(std::remove_if(Candidates.begin(), Candidates.end(),
+                                  [](const HeatSpecializationCandidate &C) {
+                                    return C.Score==0;
+                                  }),
+                   Candidates.end());
+  std::stable_sort(Candidates.begin(), Candidates.end(),
+                   [](const HeatSpecializationCandidate &A,
+                      const HeatSpecializationCandidate &B) {
+                     return A.Score>B.Score;
+                   });
+  return Candidates;
+}
+
+void printHeatSpecializationCandidates(
+    raw_ostream &OS, ArrayRef<HeatSpecializationCandidate> Candidates,
+    unsigned MaxCandidates){
+  OS << "# score calls call-sites affected-size callee argument value\n";
+  for (unsigned i = 0; i<Candidates.size() && i<MaxCandidates; i++) {
+    const HeatSpecializationCandidate &Cand = Candidates[i];
+    OS << Cand.Score << " " << Cand.Freq << " " << Cand.NumCallSites << " "
+       << Cand.AffectedSize << " " << Cand.Callee->getName() << " "
+       << Cand.ArgNo << " ";
+    if (Cand.Value)
+      Cand.Value->printAsOperand(OS, true, Cand.Callee->getParent());
+    else
+      OS << "<loop invariant>";
+    OS << "\n";
+  }
+}
+
+}
@@ -0,0 +1,67 @@
+//===-- HeatSpecialization.h - Specialization candidates --------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the search for function specialization candidates: the
+// arguments that hot call sites pass as a constant, or as a value invariant
+// in the loop around the call. Candidates are ranked by the frequency of
+// their call sites times the size of the callee that depends on the argument,
+// which estimates the work that specializing on the argument could simplify.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATSPECIALIZATION_H
+#define LLVM_ANALYSIS_HEATSPECIALIZATION_H
+
+#include "HeatProfile.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/IR/Constant.h"
+#include "llvm/IR/Function.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+struct HeatSpecializationCandidate {
+  const Function *Callee;
+  unsigned ArgNo;
+  /// Constant passed as the argument, or null for arguments that are only
+  /// invariant in the loop around the calls.
+  const Constant *Value;
+  /// Number of calls, i.e. the sum of the frequencies of the call sites.
+  uint64_t Freq;
+  unsigned NumCallSites;
+  /// Number of instructions of the callee that depend on the argument,
+  /// including the blocks of the branches on it.
+  unsigned AffectedSize;
+  /// Freq times AffectedSize.
+  uint64_t Score;
+};
+
+/// Returns the candidates of the call sites of \p HP with heat of at least
+/// \p MinHeat, by decreasing score. \p LookupLI is called once per calling
+/// function, to find the loops around the call sites.
+std::vector<HeatSpecializationCandidate>
+findHeatSpecializationCandidates(const HeatProfile &HP,
+                                 function_ref<LoopInfo *(Function &)> LookupLI,
+                                 double MinHeat);
+
+/// Prints the first \p MaxCandidates candidates.
+void printHeatSpecializationCandidates(
+    raw_ostream &OS, ArrayRef<HeatSpecializationCandidate> Candidates,
+    unsigned MaxCandidates);
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+
+#include "HeatSummary.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace llvm {
+
+bool HeatShard::contains(const Function &F) const {
+  return (MD5Hash(F.getName())%Count)==Index;
+}
+
+bool HeatShard::parse(StringRef Str, HeatShard &Shard){
+  std::pair<StringRef, StringRef> Parts = Str.split('/');
+  unsigned Index, Count;
+  if (Parts.first.getAsInteger(10,Index) ||
+      Parts.second.getAsInteger(10,Count))
+    return false;
+  if (Count==0 || Index>=Count)
+    return false;
+  Shard.Index = Index;
+  Shard.Count = Count;
+  return true;
+}
+
+std::string HeatShard::str() const {
+  return std::to_string(Index) + "-of-" + std::to_string(Count);
+}
+
+HeatSummary HeatSummary::get(const HeatProfile &HP){
+  HeatSummary Summary;
+  Summary.HasProfiling = HP.hasProfiling();
+  Summary.MaxFreq = HP.getMaxFreq();
+  for (unsigned FI = 0; FI<HP.getNumFunctions(); FI++)
+    Summary.FunctionMaxFreq.push_back(
+        std::make_pair(HP.getFunction(FI)->getName().str(),
+                       HP.getFunctionMaxFreq(FI)));
+  return Summary;
+}
+
+void HeatSummary::print(raw_ostream &OS) const {
+  OS << "heat-summary 1\n";
+  OS << "profiling " << (HasProfiling?1:0) << "\n";
+  OS << "max-freq " << MaxFreq << "\n";
+  for (auto &Entry : FunctionMaxFreq)
+    OS << Entry.second << " " << Entry.first << "\n";
+}
+
+bool HeatSummary::write(StringRef Filename) const {
+  std::error_code EC;
+  raw_fd_ostream File(Filename, EC, sys::fs::F_Text);
+  if (EC)
+    return false;
+  print(File);
+  return true;
+}
+
+bool HeatSummary::read(StringRef Filename, HeatSummary &Summary,
+                       std::string &Error){
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Buffer =
+      MemoryBuffer::getFile(Filename);
+  if (!Buffer) {
+    Error = Buffer.getError().message();
+    return false;
+  }
+
+  SmallVector<StringRef, 16> Lines;
+  (*Buffer)->getBuffer().split(Lines, '\n', -1, false);
+  if (Lines.size()<3 || Lines[0].rtrim()!="heat-summary 1") {
+    Error = "not a heat summary file";
+    return false;
+  }
+
+  Summary = HeatSummary();
+  unsigned Profiling;
+  if (!Lines[1].consume_front("profiling ") ||
+      Lines[1].rtrim().getAsInteger(10,Profiling) ||
+      !Lines[2].consume_front("max-freq ") ||
+      Lines[2].rtrim().getAsInteger(10,Summary.MaxFreq)) {
+    Error = "malformed heat summary header";
+    return false;
+  }
+  Summary.HasProfiling = Profiling;
+
+  for (unsigned i = 3; i<Lines.size(); i++) {
+    std::pair<StringRef, StringRef> Entry = Lines[i].rtrim().split(' ');
+    uint64_t Freq;
+    if (Entry.first.getAsInteger(10,Freq) || Entry.second.empty()) {
+      Error = "malformed heat summary entry at line " + std::to_string(i+1);
+      return false;
+    }
+    Summary.FunctionMaxFreq.push_back(std::make_pair(Entry.second.str(),Freq));
+  }
+  return true;
+}
+
+}
@@ -0,0 +1,74 @@
+//===-- HeatSummary.h - Heat summary and sharding ---------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the heat summary of a module, a small text file with its
+// maximum frequency and the maximum frequency of each function, and the
+// sharding of the functions of a module, used to split the heat generation
+// of a huge module across several build nodes. Each node processes a shard,
+// taking the module maximum frequency from a precomputed summary.
+//
+// The summary file has the format:
+//   heat-summary 1
+//   profiling <0|1>
+//   max-freq <freq>
+//   <freq> <function name>
+//   ...
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATSUMMARY_H
+#define LLVM_ANALYSIS_HEATSUMMARY_H
+
+#include "HeatProfile.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/Function.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+/// Shard \p Index of \p Count. A function belongs to the shard selected by
+/// the MD5 hash of its name, which is stable across runs and build nodes.
+struct HeatShard {
+  unsigned Index = 0;
+  unsigned Count = 1;
+
+  bool contains(const Function &F) const;
+
+  /// Parses a shard given as "i/N".
+  static bool parse(StringRef Str, HeatShard &Shard);
+
+  /// Returns "i-of-N", used as a file name suffix.
+  std::string str() const;
+};
+
+struct HeatSummary {
+  bool HasProfiling = false;
+  uint64_t MaxFreq = 0;
+  std::vector<std::pair<std::string, uint64_t>> FunctionMaxFreq;
+
+  static HeatSummary get(const HeatProfile &HP);
+
+  void print(raw_ostream &OS) const;
+
+  bool write(StringRef Filename) const;
+
+  static bool read(StringRef Filename, HeatSummary &Summary,
+                   std::string &Error);
+};
+
+}
+
+#endif
@@ -0,0 +1,47 @@
+//===-- HeatSummaryPrinter.cpp - Heat summary printer -----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-summary' analysis pass, which emits the
+// <module>.heatsummary file with the maximum frequency of the module and of
+// each of its functions.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeatSummaryPrinter.h"
+#include "HeatPrinterOptions.h"
+#include "HeatSummary.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+bool HeatSummaryPrinterPass::runOnModule(Module &M) {
+  HeatProfile &HP = getHeatProfile(M,getHeatProfileOptions());
+
+  std::string Filename = getHeatOutputFilename(M.getModuleIdentifier(),
+                                               getHeatOutputTag(),
+                                               ".heatsummary");
+  HeatSummary Summary = HeatSummary::get(HP);
+  writeHeatReport(Filename,[&](raw_ostream &OS) { Summary.print(OS); });
+  return false;
+}
+
+}
+
+char HeatSummaryPrinterPass::ID = 0;
+static RegisterPass<HeatSummaryPrinterPass> X("heat-summary",
+                   "Print the heat summary of the module.", false, false);
@@ -0,0 +1,39 @@
+//===-- HeatSummaryPrinter.h - Heat summary printer -------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-summary' analysis pass, which emits the
+// <module>.heatsummary file with the maximum frequency of the module and of
+// each of its functions. The summary is used by the shards of the heat CFG
+// printers (-heat-shard) to scale their heat consistently.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATSUMMARYPRINTER_H
+#define LLVM_ANALYSIS_HEATSUMMARYPRINTER_H
+
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace {
+
+class HeatSummaryPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatSummaryPrinterPass() : HeatReportPass(ID) {}
+
+  bool runOnModule(Module &M) override;
+};
+
+}
+
+#endif
@@ -0,0 +1,169 @@
+
+#include "HeatSupergraph.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/ModuleSlotTracker.h"
+#include "llvm/Support/GraphWriter.h"
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+namespace llvm {
+
+std::string getHeatSupergraphFilename(const Function &Root, StringRef Tag){
+  return getHeatOutputFilename(("heatsupergraph." + Root.getName()).str(),
+                               Tag,".dot");
+}
+
+/// Returns true if \p FI is already expanded on the call chain of instance
+/// \p I, so that recursive calls are not unrolled.
+static bool isOnCallChain(const HeatSupergraph &G, unsigned I, unsigned FI){
+  while (true) {
+    if (G.Instances[I].Function==FI)
+      return true;
+    if (I==0)
+      return false;
+    I = G.Instances[I].Parent;
+  }
+}
+
+HeatSupergraph buildHeatSupergraph(const HeatProfile &HP, const Function &Root,
+                                   const HeatSupergraphOptions &Opts){
+  HeatSupergraph G;
+  int RootFI = HP.getFunctionIndex(&Root);
+  assert(RootFI>=0 && "root function is not in the profile");
+
+  HeatSupergraphInstance RootInst = {unsigned(RootFI), 0, 1.0, 0, nullptr, 0};
+  G.Instances.push_back(RootInst);
+  G.NumNodes = HP.blocks(RootFI).size();
+
+  // Candidate call sites, as (scaled frequency, caller instance, call site
+  // index in the profile), hottest first.
+  typedef std::pair<uint64_t, std::pair<unsigned, unsigned>> Candidate;
+  std::priority_queue<Candidate> Queue;
+  auto addCallSites = [&](unsigned I) {
+    const HeatSupergraphInstance &Inst = G.Instances[I];
+    if (Inst.Depth>=Opts.MaxDepth)
+      return;
+    ArrayRef<HeatCallSite> Calls = HP.callSites();
+    ArrayRef<HeatCallSite> Own = HP.callSites(Inst.Function);
+    unsigned First = Own.data()-Calls.data();
+    for (unsigned i = 0; i<Own.size(); i++) {
+      if (!Own[i].Callee || HP.getFunctionIndex(Own[i].Callee)<0)
+        continue;
+      uint64_t Freq = uint64_t(Own[i].Freq*Inst.Scale);
+      Queue.push(Candidate(Freq,std::make_pair(I,First+i)));
+    }
+  };
+  addCallSites(0);
+
+  while (!Queue.empty()) {
+    Candidate Top = Queue.top();
+    Queue.pop();
+    uint64_t CallFreq = Top.first;
+    // Candidates come hottest first, so none of the rest is hot enough.
+    if (HP.getHeat(CallFreq)<Opts.MinHeat)
+      break;
+
+    unsigned Parent = Top.second.first;
+    const HeatCallSite &Call = HP.callSites()[Top.second.second];
+    unsigned CalleeFI = HP.getFunctionIndex(Call.Callee);
+    unsigned Size = HP.blocks(CalleeFI).size();
+    if (G.NumNodes+Size>Opts.MaxNodes || isOnCallChain(G,Parent,CalleeFI))
+      continue;
+
+    uint64_t EntryFreq = HP.getBlockFreq(HP.getFirstBlock(CalleeFI));
+    HeatSupergraphInstance Inst;
+    Inst.Function = CalleeFI;
+    Inst.Depth = G.Instances[Parent].Depth+1;
+    Inst.Scale = EntryFreq?double(CallFreq)/EntryFreq:0.0;
+    Inst.Parent = Parent;
+    Inst.CallSite = Call.Call;
+    Inst.CallFreq = CallFreq;
+    G.Instances.push_back(Inst);
+    G.NumNodes += Size;
+    addCallSites(G.Instances.size()-1);
+  }
+  return G;
+}
+
+static void writeNode(raw_ostream &OS, const HeatProfile &HP, unsigned I,
+                      unsigned BI, uint64_t Freq, ModuleSlotTracker &MST){
+  const BasicBlock *BB = HP.blocks()[BI];
+  std::string Label;
+  if (!BB->getName().empty()) {
+    Label = BB->getName().str();
+  } else {
+    raw_string_ostream LS(Label);
+    BB->printAsOperand(LS, false, MST);
+    LS.flush();
+  }
+  Label += "\n" + std::to_string(Freq);
+
+  uint64_t MaxFreq = HP.getMaxFreq();
+  std::string color = getHeatColor(Freq, MaxFreq);
+  std::string edgeColor = (Freq<=(MaxFreq/2))?
+                          (getHeatColor(0)):(getHeatColor(1));
+  OS << "\t\ti" << I << "b" << BI << " [label=\""
+     << DOT::EscapeString(Label) << "\",color=\"" << edgeColor
+     << "ff\", style=filled, fillcolor=\"" << color << "80\"];\n";
+}
+
+void writeHeatSupergraph(raw_ostream &OS, const HeatProfile &HP,
+                         const HeatSupergraph &G){
+  const Function &Root = *HP.getFunction(G.Instances[0].Function);
+  std::string Title = "Heat supergraph for '" + Root.getName().str() +
+                      "' function";
+  OS << "digraph \"" << DOT::EscapeString(Title) << "\" {\n";
+  OS << "\tlabel=\"" << DOT::EscapeString(Title) << "\";\n";
+  OS << "\tnode [shape=record];\n\n";
+
+  ModuleSlotTracker MST(&HP.getModule(), false);
+  for (unsigned I = 0; I<G.Instances.size(); I++) {
+    const HeatSupergraphInstance &Inst = G.Instances[I];
+    const Function &F = *HP.getFunction(Inst.Function);
+    MST.incorporateFunction(F);
+
+    std::string Label = F.getName().str();
+    if (I)
+      Label += " (calls " + std::to_string(Inst.CallFreq) + ")";
+    OS << "\tsubgraph cluster_" << I << " {\n";
+    OS << "\t\tlabel=\"" << DOT::EscapeString(Label) << "\";\n";
+
+    unsigned FirstBlock = HP.getFirstBlock(Inst.Function);
+    ArrayRef<uint64_t> Freqs = HP.blockFreqs(Inst.Function);
+    for (unsigned b = 0; b<Freqs.size(); b++)
+      writeNode(OS,HP,I,FirstBlock+b,uint64_t(Freqs[b]*Inst.Scale),MST);
+
+    for (unsigned b = 0; b<Freqs.size(); b++) {
+      const BasicBlock *BB = HP.blocks()[FirstBlock+b];
+      for (const BasicBlock *Succ : successors(BB))
+        OS << "\t\ti" << I << "b" << FirstBlock+b << " -> i" << I << "b"
+           << HP.getBlockIndex(Succ) << ";\n";
+    }
+    OS << "\t}\n";
+  }
+
+  // Calls from the block of the call site to the entry of the callee, and
+  // returns from the returning blocks of the callee back to it.
+  for (unsigned I = 1; I<G.Instances.size(); I++) {
+    const HeatSupergraphInstance &Inst = G.Instances[I];
+    unsigned CallBI = HP.getBlockIndex(Inst.CallSite->getParent());
+    unsigned FirstBlock = HP.getFirstBlock(Inst.Function);
+    OS << "\ti" << Inst.Parent << "b" << CallBI << " -> i" << I << "b"
+       << FirstBlock << " [style=dashed,label=\"" << Inst.CallFreq
+       << "\"];\n";
+    ArrayRef<const BasicBlock *> Blocks = HP.blocks(Inst.Function);
+    for (unsigned b = 0; b<Blocks.size(); b++)
+      if (isa<ReturnInst>(Blocks[b]->getTerminator()))
+        OS << "\ti" << I << "b" << FirstBlock+b << " -> i" << Inst.Parent
+           << "b" << CallBI << " [style=dotted];\n";
+  }
+  OS << "}\n";
+}
+
+}
@@ -0,0 +1,79 @@
+//===-- HeatSupergraph.h - Interprocedural heat CFG -------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the heat supergraph of a function: its CFG with the CFGs
+// of the callees embedded at the hot call sites, recursively up to a depth,
+// so that hot code can be followed across calls in a single graph.
+//
+// The frequencies of an embedded callee are scaled by the frequency of its
+// call site relative to the entry frequency of the callee, and the heat is
+// relative to the maximum frequency of the module. Call sites are expanded
+// from the hottest one while the graph stays within a budget of nodes.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATSUPERGRAPH_H
+#define LLVM_ANALYSIS_HEATSUPERGRAPH_H
+
+#include "HeatProfile.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instruction.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+struct HeatSupergraphOptions {
+  /// Maximum depth of the embedded callees, the root being at depth 0.
+  unsigned MaxDepth = 2;
+  /// Maximum number of blocks of the graph. The root is always included.
+  unsigned MaxNodes = 500;
+  /// Call sites whose scaled heat is lower than this are not expanded.
+  double MinHeat = 0.01;
+};
+
+/// A function embedded in the supergraph.
+struct HeatSupergraphInstance {
+  /// Index of the function in the profile.
+  unsigned Function;
+  unsigned Depth;
+  /// Factor applied to the frequencies of the function.
+  double Scale;
+  /// Instance of the caller and call site, for all but the root.
+  unsigned Parent;
+  const Instruction *CallSite;
+  /// Scaled frequency of the call site.
+  uint64_t CallFreq;
+};
+
+struct HeatSupergraph {
+  /// Instances in the order they were expanded, the root first.
+  std::vector<HeatSupergraphInstance> Instances;
+  unsigned NumNodes = 0;
+};
+
+/// Returns heatsupergraph.<fnname>.dot, or heatsupergraph.<fnname>.<tag>.dot.
+std::string getHeatSupergraphFilename(const Function &Root,
+                                      StringRef Tag = "");
+
+/// Builds the supergraph of \p Root, which must be in \p HP.
+HeatSupergraph buildHeatSupergraph(const HeatProfile &HP, const Function &Root,
+                                   const HeatSupergraphOptions &Opts);
+
+void writeHeatSupergraph(raw_ostream &OS, const HeatProfile &HP,
+                         const HeatSupergraph &G);
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+//===-- HeatSupergraphPrinter.cpp - Heat supergraph printer -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'dot-heat-supergraph' analysis pass, which emits the
+// heatsupergraph.<fnname>.dot file with the heat CFG of a root function and
+// the CFGs of its callees embedded at the hot call sites.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeatSupergraphPrinter.h"
+#include "HeatPrinterOptions.h"
+#include "HeatSupergraph.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+
+using namespace llvm;
+
+
+static cl::opt<std::string>
+SupergraphRoot("heat-supergraph-root", cl::init(""), cl::Hidden,
+               cl::desc("Root function of the supergraph (the hottest "
+                        "function by default)"));
+
+static cl::opt<unsigned>
+SupergraphDepth("heat-supergraph-depth", cl::init(2), cl::Hidden,
+                cl::desc("Maximum depth of the embedded callees"));
+
+static cl::opt<unsigned>
+SupergraphMaxNodes("heat-supergraph-max-nodes", cl::init(500), cl::Hidden,
+                   cl::desc("Maximum number of blocks of the supergraph"));
+
+static cl::opt<double>
+SupergraphMinHeat("heat-supergraph-min-heat", cl::init(0.01), cl::Hidden,
+                  cl::desc("Minimum heat, in [0,1], of the expanded calls"));
+
+static const Function *getSupergraphRoot(const HeatProfile &HP){
+  if (!SupergraphRoot.empty()) {
+    const Function *F = HP.getModule().getFunction(SupergraphRoot);
+    if (!F || HP.getFunctionIndex(F)<0) {
+      HeatLog() << "Function '" << SupergraphRoot << "' not found in module!\n";
+      return nullptr;
+    }
+    return F;
+  }
+
+  const Function *Hottest = nullptr;
+  uint64_t MaxFreq = 0;
+  for (unsigned FI = 0; FI<HP.getNumFunctions(); FI++) {
+    if (!Hottest || HP.getFunctionMaxFreq(FI)>MaxFreq) {
+      Hottest = HP.getFunction(FI);
+      MaxFreq = HP.getFunctionMaxFreq(FI);
+    }
+  }
+  return Hottest;
+}
+
+namespace {
+
+bool HeatSupergraphPrinterPass::runOnModule(Module &M) {
+  HeatProfile &HP = getHeatProfile(M,getHeatProfileOptions());
+  const Function *Root = getSupergraphRoot(HP);
+  if (!Root)
+    return false;
+
+  HeatSupergraphOptions Opts;
+  Opts.MaxDepth = SupergraphDepth;
+  Opts.MaxNodes = SupergraphMaxNodes;
+  Opts.MinHeat = SupergraphMinHeat;
+  HeatSupergraph G = buildHeatSupergraph(HP,*Root,Opts);
+
+  std::string Filename = getHeatSupergraphFilename(*Root,getHeatOutputTag());
+  writeHeatReport(Filename,[&](raw_ostream &OS) {
+    writeHeatSupergraph(OS,HP,G);
+  });
+  return false;
+}
+
+}
+
+char HeatSupergraphPrinterPass::ID = 0;
+static RegisterPass<HeatSupergraphPrinterPass> X("dot-heat-supergraph",
+          "Print heat map of the CFG of a function and its hot callees to "
+          "'dot' file", false, false);
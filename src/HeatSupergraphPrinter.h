@@ -0,0 +1,37 @@
+//===-- HeatSupergraphPrinter.h - Heat supergraph printer -------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'dot-heat-supergraph' analysis pass, which emits the
+// heat CFG of a function with the CFGs of its hot callees embedded.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATSUPERGRAPHPRINTER_H
+#define LLVM_ANALYSIS_HEATSUPERGRAPHPRINTER_H
+
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace {
+
+class HeatSupergraphPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatSupergraphPrinterPass() : HeatReportPass(ID) {}
+
+  bool runOnModule(Module &M) override;
+};
+
+}
+
+#endif
@@ -0,0 +1,68 @@
+//===-- HeatSwitchPrinter.cpp - Switch heat report printer ------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-switch-report' analysis pass, which emits the
+// <module>.heatswitches.txt report with the frequency of the cases of the
+// hot switch instructions, their predicted lowering and the hot cases worth
+// peeling.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeatSwitchPrinter.h"
+#include "HeatPrinterOptions.h"
+#include "HeatSwitchReport.h"
+#include "HeatUtils.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+
+static cl::opt<double>
+SwitchMinHeat("heat-switch-min-heat", cl::init(0.1), cl::Hidden,
+              cl::desc("Minimum heat, in [0,1], of the reported switches"));
+
+static cl::opt<double>
+SwitchPeelShare("heat-switch-peel-share", cl::init(0.2), cl::Hidden,
+                cl::desc("Minimum share of the switch frequency of a case "
+                         "suggested for peeling"));
+
+static cl::opt<unsigned>
+SwitchMaxCases("heat-switch-cases", cl::init(10), cl::Hidden,
+               cl::desc("Number of hottest cases listed per switch"));
+
+namespace {
+
+bool HeatSwitchPrinterPass::runOnModule(Module &M) {
+  HeatProfile &HP = getHeatProfile(M,getHeatProfileOptions());
+  std::vector<HeatSwitchInfo> Switches =
+      getHotSwitches(HP,SwitchMinHeat,SwitchPeelShare);
+
+  std::string Filename = getHeatOutputFilename(M.getModuleIdentifier(),
+                                               getHeatOutputTag(),
+                                               ".heatswitches.txt");
+  writeHeatReport(Filename,[&](raw_ostream &OS) {
+    printHeatSwitchReport(OS,HP,Switches,SwitchMaxCases);
+  });
+  return false;
+}
+
+}
+
+char HeatSwitchPrinterPass::ID = 0;
+static RegisterPass<HeatSwitchPrinterPass> X("heat-switch-report",
+          "Print the heat report of the hot switch instructions.",
+          false, false);
@@ -0,0 +1,37 @@
+//===-- HeatSwitchPrinter.h - Switch heat report printer --------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a 'heat-switch-report' analysis pass, which emits the
+// <module>.heatswitches.txt report of the hot switch instructions.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATSWITCHPRINTER_H
+#define LLVM_ANALYSIS_HEATSWITCHPRINTER_H
+
+#include "HeatReportPass.h"
+
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+
+using namespace llvm;
+
+namespace {
+
+class HeatSwitchPrinterPass : public HeatReportPass {
+public:
+  static char ID;
+  HeatSwitchPrinterPass() : HeatReportPass(ID) {}
+
+  bool runOnModule(Module &M) override;
+};
+
+}
+
+#endif
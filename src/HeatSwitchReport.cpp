@@ -0,0 +1,171 @@
+
+#include "HeatSwitchReport.h"
+
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/ModuleSlotTracker.h"
+#include "llvm/Support/Format.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace llvm {
+
+// Default thresholds of SelectionDAG for switch lowering.
+static const unsigned MinJumpTableEntries = 4;
+static const double MinJumpTableDensity = 0.10;
+static const unsigned MaxBitTestDests = 3;
+static const unsigned BitTestRange = 64;
+
+static const unsigned MaxPeeled = 3;
+
+static HeatSwitchLowering getLowering(unsigned NumCases, unsigned NumDests,
+                                      uint64_t Range, double Density){
+  // The default destination is not tested by bit tests.
+  if (NumCases>0 && Range<=BitTestRange && NumDests-1<=MaxBitTestDests)
+    return HeatSwitchLowering::BitTests;
+  if (NumCases>=MinJumpTableEntries && Density>=MinJumpTableDensity)
+    return HeatSwitchLowering::JumpTable;
+  return HeatSwitchLowering::CompareTree;
+}
+
+static HeatSwitchInfo getSwitchInfo(const HeatProfile &HP, unsigned FI,
+                                    unsigned BI, const SwitchInst *SI,
+                                    double PeelShare){
+  HeatSwitchInfo Info;
+  Info.Switch = SI;
+  Info.Function = FI;
+  Info.Freq = HP.getBlockFreq(BI);
+
+  ArrayRef<uint64_t> EdgeFreqs = HP.edgeFreqs(BI);
+  HeatSwitchCase Default = {nullptr, 0, EdgeFreqs[0]};
+  Info.Cases.push_back(Default);
+
+  DenseSet<const BasicBlock *> Dests;
+  Dests.insert(SI->getDefaultDest());
+  APInt Min, Max;
+  bool First = true;
+  for (auto Case : SI->cases()) {
+    const ConstantInt *Value = Case.getCaseValue();
+    unsigned SuccIdx = Case.getSuccessorIndex();
+    HeatSwitchCase C = {Value, SuccIdx, EdgeFreqs[SuccIdx]};
+    Info.Cases.push_back(C);
+    Dests.insert(Case.getCaseSuccessor());
+
+    const APInt &V = Value->getValue();
+    if (First || V.slt(Min))
+      Min = V;
+    if (First || V.sgt(Max))
+      Max = V;
+    First = false;
+  }
+  Info.NumDests = Dests.size();
+
+  unsigned NumCases = SI->getNumCases();
+  uint64_t Range = 0;
+  if (NumCases>0)
+    Range = (Max-Min).getLimitedValue(UINT64_MAX-1)+1;
+  Info.Density = Range?double(NumCases)/Range:0.0;
+  Info.Lowering = getLowering(NumCases,Info.NumDests,Range,Info.Density);
+
+  std::stable_sort(Info.Cases.begin(), Info.Cases.end(),
+                   [](const HeatSwitchCase &A, const HeatSwitchCase &B) {
+                     return A.Freq>B.Freq;
+                   });
+
+  // Only cases, not the default destination, can be peeled, and only while
+  // they are the hottest ones.
+  Info.NumPeeled = 0;
+  while (Info.NumPeeled<MaxPeeled && Info.NumPeeled<Info.Cases.size()) {
+    const HeatSwitchCase &C = Info.Cases[Info.NumPeeled];
+    if (!C.Value || Info.Freq==0 || double(C.Freq)/Info.Freq<PeelShare)
+      break;
+    Info.NumPeeled++;
+  }
+  return Info;
+}
+
+std::vector<HeatSwitchInfo> getHotSwitches(const HeatProfile &HP,
+                                           double MinHeat, double PeelShare){
+  std::vector<HeatSwitchInfo> Switches;
+  for (unsigned FI = 0; FI<HP.getNumFunctions(); FI++) {
+    unsigned FirstBlock = HP.getFirstBlock(FI);
+    ArrayRef<const BasicBlock *> Blocks = HP.blocks(FI);
+    for (unsigned i = 0; i<Blocks.size(); i++) {
+      const SwitchInst *SI = dyn_cast<SwitchInst>(Blocks[i]->getTerminator());
+      if (!SI || HP.getHeat(HP.getBlockFreq(FirstBlock+i))<MinHeat)
+        continue;
+      Switches.push_back(getSwitchInfo(HP,FI,FirstBlock+i,SI,PeelShare));
+    }
+  }
+  std::stable_sort(Switches.begin(), Switches.end(),
+                   [](const HeatSwitchInfo &A, const HeatSwitchInfo &B) {
+                     return A.Freq>B.Freq;
+                   });
+  return Switches;
+}
+
+static const char *getLoweringName(HeatSwitchLowering Lowering){
+  switch (Lowering) {
+  case HeatSwitchLowering::JumpTable:
+    return "jump table";
+  case HeatSwitchLowering::BitTests:
+    return "bit tests";
+  case HeatSwitchLowering::CompareTree:
+    return "compare tree";
+  }
+  return "";
+}
+
+static void printCase(raw_ostream &OS, const HeatSwitchCase &C){
+  if (C.Value)
+    OS << "case " << C.Value->getValue();
+  else
+    OS << "default";
+}
+
+void printHeatSwitchReport(raw_ostream &OS, const HeatProfile &HP,
+                           ArrayRef<HeatSwitchInfo> Switches,
+                           unsigned MaxCases){
+  // Numbering the unnamed blocks of a function takes a walk over it, which
+  // the tracker only repeats when the function changes.
+  ModuleSlotTracker MST(&HP.getModule(), false);
+  for (const HeatSwitchInfo &Info : Switches) {
+    const BasicBlock *BB = Info.Switch->getParent();
+    const Function *F = HP.getFunction(Info.Function);
+    if (MST.getCurrentFunction()!=F)
+      MST.incorporateFunction(*F);
+    OS << "switch in " << F->getName() << ", ";
+    BB->printAsOperand(OS, false, MST);
+    OS << "\n";
+    OS << "  freq " << Info.Freq << ", heat "
+       << format("%.2f", HP.getHeat(Info.Freq)) << "\n";
+    OS << "  cases " << Info.Switch->getNumCases() << ", destinations "
+       << Info.NumDests << ", density " << format("%.2f", Info.Density)
+       << ", lowering " << getLoweringName(Info.Lowering) << "\n";
+
+    for (unsigned i = 0; i<Info.Cases.size() && i<MaxCases; i++) {
+      const HeatSwitchCase &C = Info.Cases[i];
+      double Share = Info.Freq?100.0*C.Freq/Info.Freq:0.0;
+      OS << "  " << C.Freq << " " << format("%5.1f%%", Share) << " ";
+      printCase(OS,C);
+      OS << "\n";
+    }
+    if (Info.Cases.size()>MaxCases)
+      OS << "  ... " << (Info.Cases.size()-MaxCases) << " more\n";
+
+    if (Info.NumPeeled) {
+      OS << "  peel";
+      for (unsigned i = 0; i<Info.NumPeeled; i++) {
+        OS << (i?", ":" ");
+        printCase(OS,Info.Cases[i]);
+      }
+      OS << "\n";
+    }
+    OS << "\n";
+  }
+}
+
+}
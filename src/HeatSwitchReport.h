@@ -0,0 +1,78 @@
+//===-- HeatSwitchReport.h - Heat of switch instructions --------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the heat report of the hot switch instructions of a
+// module, such as the dispatch switches of interpreters. For each switch it
+// gives the frequency of its cases, the density of the case values and
+// whether it is likely lowered to a jump table, to bit tests or to a tree of
+// compares, and suggests the hot cases that are worth peeling off.
+//
+// The lowering prediction follows the default thresholds of SelectionDAG for
+// a single cluster of cases, so it is only an approximation: the backend may
+// still split a sparse switch into several dense clusters.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_HEATSWITCHREPORT_H
+#define LLVM_ANALYSIS_HEATSWITCHREPORT_H
+
+#include "HeatProfile.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <vector>
+
+using namespace llvm;
+
+namespace llvm {
+
+enum class HeatSwitchLowering { JumpTable, BitTests, CompareTree };
+
+struct HeatSwitchCase {
+  /// Case value, or null for the default destination.
+  const ConstantInt *Value;
+  unsigned SuccessorIndex;
+  uint64_t Freq;
+};
+
+struct HeatSwitchInfo {
+  const SwitchInst *Switch;
+  /// Index of the function in the profile.
+  unsigned Function;
+  /// Frequency of the block of the switch.
+  uint64_t Freq;
+  /// Number of distinct destinations, including the default one.
+  unsigned NumDests;
+  /// Number of case values over the size of their range.
+  double Density;
+  HeatSwitchLowering Lowering;
+  /// Cases and default, by decreasing frequency.
+  std::vector<HeatSwitchCase> Cases;
+  /// The first NumPeeled cases are suggested to be peeled off the switch.
+  unsigned NumPeeled;
+};
+
+/// Returns the switches of \p HP whose heat is at least \p MinHeat, by
+/// decreasing frequency. Cases are suggested for peeling, at most three and
+/// by decreasing frequency, while each takes at least \p PeelShare of the
+/// frequency of the switch.
+std::vector<HeatSwitchInfo> getHotSwitches(const HeatProfile &HP,
+                                           double MinHeat, double PeelShare);
+
+/// Prints the report, listing at most \p MaxCases cases per switch.
+void printHeatSwitchReport(raw_ostream &OS, const HeatProfile &HP,
+                           ArrayRef<HeatSwitchInfo> Switches,
+                           unsigned MaxCases);
+
+}
+
+#endif
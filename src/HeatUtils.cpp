@@ -2,10 +2,20 @@
 #include "HeatUtils.h"
 
 #include "llvm/IR/Instructions.h"
+#include "llvm/Support/FileSystem.h"
+
+#include <atomic>
+#include <mutex>
+
+#ifdef LLVM_ON_WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 namespace llvm {
 
-static const std::string heatPalette[100] = {"#3d50c3", "#4055c8", "#4358cb", "#465ecf", "#4961d2", "#4c66d6", "#4f69d9", "#536edd", "#5572df", "#5977e3", "#5b7ae5", "#5f7fe8", "#6282ea", "#6687ed", "#6a8bef", "#6c8ff1", "#7093f3", "#7396f5", "#779af7", "#7a9df8", "#7ea1fa", "#81a4fb", "#85a8fc", "#88abfd", "#8caffe", "#8fb1fe", "#93b5fe", "#96b7ff", "#9abbff", "#9ebeff", "#a1c0ff", "#a5c3fe", "#a7c5fe", "#abc8fd", "#aec9fc", "#b2ccfb", "#b5cdfa", "#b9d0f9", "#bbd1f8", "#bfd3f6", "#c1d4f4", "#c5d6f2", "#c7d7f0", "#cbd8ee", "#cedaeb", "#d1dae9", "#d4dbe6", "#d6dce4", "#d9dce1", "#dbdcde", "#dedcdb", "#e0dbd8", "#e3d9d3", "#e5d8d1", "#e8d6cc", "#ead5c9", "#ecd3c5", "#eed0c0", "#efcebd", "#f1ccb8", "#f2cab5", "#f3c7b1", "#f4c5ad", "#f5c1a9", "#f6bfa6", "#f7bca1", "#f7b99e", "#f7b599", "#f7b396", "#f7af91", "#f7ac8e", "#f7a889", "#f6a385", "#f5a081", "#f59c7d", "#f4987a", "#f39475", "#f29072", "#f08b6e", "#ef886b", "#ed8366", "#ec7f63", "#e97a5f", "#e8765c", "#e57058", "#e36c55", "#e16751", "#de614d", "#dc5d4a", "#d85646", "#d65244", "#d24b40", "#d0473d", "#cc403a", "#ca3b37", "#c53334", "#c32e31", "#be242e", "#bb1b2c", "#b70d28"};
+static const char *const heatPalette[100] = {"#3d50c3", "#4055c8", "#4358cb", "#465ecf", "#4961d2", "#4c66d6", "#4f69d9", "#536edd", "#5572df", "#5977e3", "#5b7ae5", "#5f7fe8", "#6282ea", "#6687ed", "#6a8bef", "#6c8ff1", "#7093f3", "#7396f5", "#779af7", "#7a9df8", "#7ea1fa", "#81a4fb", "#85a8fc", "#88abfd", "#8caffe", "#8fb1fe", "#93b5fe", "#96b7ff", "#9abbff", "#9ebeff", "#a1c0ff", "#a5c3fe", "#a7c5fe", "#abc8fd", "#aec9fc", "#b2ccfb", "#b5cdfa", "#b9d0f9", "#bbd1f8", "#bfd3f6", "#c1d4f4", "#c5d6f2", "#c7d7f0", "#cbd8ee", "#cedaeb", "#d1dae9", "#d4dbe6", "#d6dce4", "#d9dce1", "#dbdcde", "#dedcdb", "#e0dbd8", "#e3d9d3", "#e5d8d1", "#e8d6cc", "#ead5c9", "#ecd3c5", "#eed0c0", "#efcebd", "#f1ccb8", "#f2cab5", "#f3c7b1", "#f4c5ad", "#f5c1a9", "#f6bfa6", "#f7bca1", "#f7b99e", "#f7b599", "#f7b396", "#f7af91", "#f7ac8e", "#f7a889", "#f6a385", "#f5a081", "#f59c7d", "#f4987a", "#f39475", "#f29072", "#f08b6e", "#ef886b", "#ed8366", "#ec7f63", "#e97a5f", "#e8765c", "#e57058", "#e36c55", "#e16751", "#de614d", "#dc5d4a", "#d85646", "#d65244", "#d24b40", "#d0473d", "#cc403a", "#ca3b37", "#c53334", "#c32e31", "#be242e", "#bb1b2c", "#b70d28"};
 
 static const unsigned heatSize = 100;
 
@@ -37,11 +47,12 @@ uint64_t getBlockFreq(const BasicBlock *BB, BlockFrequencyInfo *BFI,
 }
 
 uint64_t getNumOfCalls(Function &callerFunction, Function &calledFunction,
-                      function_ref<BlockFrequencyInfo *(Function &)> LookupBFI){
+                      function_ref<BlockFrequencyInfo *(Function &)> LookupBFI,
+                      bool useHeuristic){
   auto *BFI = LookupBFI(callerFunction);
   uint64_t counter = 0;
   for (BasicBlock &BB : callerFunction) {
-     uint64_t freq = getBlockFreq(&BB,BFI);
+     uint64_t freq = getBlockFreq(&BB,BFI,useHeuristic);
      for (Instruction &I : BB) {
         if (CallInst *Call = dyn_cast<CallInst>(&I)) {
            if (Call->getCalledFunction()==(&calledFunction))
@@ -77,10 +88,18 @@ uint64_t getMaxFreq(Module &M,
   return maxFreq;
 }
 
-std::string getHeatColor(uint64_t freq, uint64_t maxFreq){
+unsigned getHeatBucket(uint64_t freq, uint64_t maxFreq){
+  if (maxFreq==0) return 0;
   if (freq>maxFreq) freq = maxFreq;
-  unsigned colorId = unsigned( round((double(freq)/maxFreq)*(heatSize-1.0)) );
-  return heatPalette[colorId];
+  return unsigned( round((double(freq)/maxFreq)*(heatSize-1.0)) );
+}
+
+unsigned getHeatBucketCount(){
+  return heatSize;
+}
+
+std::string getHeatColor(uint64_t freq, uint64_t maxFreq){
+  return heatPalette[getHeatBucket(freq,maxFreq)];
 }
 
 std::string getHeatColor(double percent){
@@ -92,4 +111,51 @@ std::string getHeatColor(double percent){
   return heatPalette[colorId];
 }
 
+HeatLog::~HeatLog(){
+  static std::mutex Mutex;
+  std::lock_guard<std::mutex> Lock(Mutex);
+  errs() << OS.str();
+  errs().flush();
+}
+
+static unsigned getProcessId(){
+#ifdef LLVM_ON_WIN32
+  return _getpid();
+#else
+  return getpid();
+#endif
+}
+
+std::string getUniqueHeatOutputTag(){
+  static std::atomic<unsigned> Counter(0);
+  return std::to_string(getProcessId()) + "-" + std::to_string(Counter++);
+}
+
+std::string getHeatOutputFilename(StringRef Prefix, StringRef Tag,
+                                  StringRef Suffix){
+  if (Tag.empty())
+    return (Prefix + Suffix).str();
+  return (Prefix + "." + Tag + Suffix).str();
+}
+
+void removeHeatOutputFile(StringRef Filename){
+  sys::fs::remove(Filename);
+}
+
+bool writeHeatReport(StringRef Filename,
+                     function_ref<void(raw_ostream &)> Write){
+  HeatLog Log;
+  Log << "Writing '" << Filename << "'...";
+
+  removeHeatOutputFile(Filename);
+  std::error_code EC;
+  raw_fd_ostream File(Filename, EC, sys::fs::F_Text);
+  if (!EC)
+    Write(File);
+  else
+    Log << "  error opening file for writing!";
+  Log << "\n";
+  return !EC;
+}
+
 }
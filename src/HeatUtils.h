@@ -13,10 +13,13 @@
 #ifndef LLVM_ANALYSIS_HEATUTILS_H
 #define LLVM_ANALYSIS_HEATUTILS_H
 
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
 
 #include <string>
 
@@ -40,10 +43,57 @@ uint64_t getMaxFreq(Module &M,
                     function_ref<BlockFrequencyInfo *(Function &)> LookupBFI,
                     bool useHeuristic=true);
 
+/// Index of the color of a frequency in the heat palette, from 0 (coldest)
+/// to getHeatBucketCount()-1 (hottest).
+unsigned getHeatBucket(uint64_t freq, uint64_t maxFreq);
+
+unsigned getHeatBucketCount();
+
 std::string getHeatColor(uint64_t freq, uint64_t maxFreq);
 
 std::string getHeatColor(double percent);
 
+/// A message to errs(), written as a whole when it is destroyed, so that the
+/// messages of heat passes running concurrently on several threads, e.g. in
+/// the backends of a parallel LTO build, are not interleaved.
+class HeatLog {
+public:
+  HeatLog() : OS(Buffer) {}
+  HeatLog(const HeatLog &) = delete;
+  HeatLog &operator=(const HeatLog &) = delete;
+  ~HeatLog();
+
+  template <typename T> HeatLog &operator<<(const T &Value) {
+    OS << Value;
+    return *this;
+  }
+
+private:
+  std::string Buffer;
+  raw_string_ostream OS;
+};
+
+/// Returns a tag that is different on every call, in this process and in
+/// the other processes, "<pid>-<n>". It is inserted in the names of the
+/// files written for a module, when several instances of the same module
+/// are processed concurrently.
+std::string getUniqueHeatOutputTag();
+
+/// Returns "<Prefix>.<Tag><Suffix>", or "<Prefix><Suffix>" if \p Tag is
+/// empty.
+std::string getHeatOutputFilename(StringRef Prefix, StringRef Tag,
+                                  StringRef Suffix);
+
+/// Removes \p Filename before it is written again. Output files may be hard
+/// links to objects of the output store, which must not be truncated in
+/// place.
+void removeHeatOutputFile(StringRef Filename);
+
+/// Writes the report written by \p Write to \p Filename, logging it, or
+/// logging an error if the file cannot be opened. Returns false on error.
+bool writeHeatReport(StringRef Filename,
+                     function_ref<void(raw_ostream &)> Write);
+
 }
 
 #endif
@@ -0,0 +1,159 @@
+//===-- heat-merge.cpp - Merge sharded heat outputs -------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This tool merges the outputs of the shards of the heat CFG printers
+// (-heat-shard=i/N). It checks that the index files of all the shards are
+// given, merges them into a single index sorted by heat and, optionally,
+// gathers the dot files of all the shards into one directory.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeatIndex.h"
+
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static cl::list<std::string>
+InputIndices(cl::Positional, cl::OneOrMore,
+             cl::desc("<shard index files>"));
+
+static cl::opt<std::string>
+OutputDir("o", cl::init(""), cl::value_desc("directory"),
+          cl::desc("Gather the dot files of all shards in this directory"));
+
+static cl::opt<std::string>
+OutputIndex("index", cl::init("heatcfg.index"), cl::value_desc("filename"),
+            cl::desc("Name of the merged index file"));
+
+static bool copyOutput(StringRef InputDir, StringRef Filename){
+  SmallString<256> From(InputDir);
+  sys::path::append(From, Filename);
+  SmallString<256> To(OutputDir);
+  sys::path::append(To, Filename);
+  if (From==To)
+    return true;
+  if (std::error_code EC = sys::fs::copy_file(From, To)) {
+    errs() << "error: cannot copy '" << From << "': " << EC.message() << "\n";
+    return false;
+  }
+  return true;
+}
+
+/// Copies the file of an index entry and, for paginated CFGs, its pages.
+static bool copyEntryOutputs(StringRef InputDir, StringRef Filename){
+  if (!copyOutput(InputDir, Filename))
+    return false;
+  if (!Filename.endswith(".index.dot"))
+    return true;
+  StringRef Prefix = Filename.drop_back(strlen(".index.dot"));
+  for (unsigned P = 0; ; P++) {
+    std::string Page = (Prefix + ".page" + Twine(P) + ".dot").str();
+    SmallString<256> From(InputDir);
+    sys::path::append(From, Page);
+    if (!sys::fs::exists(From))
+      return true;
+    if (!copyOutput(InputDir, Page))
+      return false;
+  }
+}
+
+int main(int argc, char **argv) {
+  sys::PrintStackTraceOnErrorSignal(argv[0]);
+  PrettyStackTraceProgram X(argc, argv);
+  llvm_shutdown_obj Y;
+
+  cl::ParseCommandLineOptions(argc, argv, "heat shard merger\n");
+
+  std::vector<HeatIndex> Indices(InputIndices.size());
+  for (unsigned i = 0; i<InputIndices.size(); i++) {
+    std::string Error;
+    if (!HeatIndex::read(InputIndices[i], Indices[i], Error)) {
+      errs() << "error: " << InputIndices[i] << ": " << Error << "\n";
+      return 1;
+    }
+  }
+
+  // Every shard must be given exactly once.
+  unsigned Count = Indices[0].Shard.Count;
+  std::vector<int> ShardInput(Count,-1);
+  bool Failed = false;
+  for (unsigned i = 0; i<Indices.size(); i++) {
+    const HeatShard &Shard = Indices[i].Shard;
+    if (Shard.Count!=Count) {
+      errs() << "error: " << InputIndices[i] << ": shard of " << Shard.Count
+             << " instead of " << Count << "\n";
+      return 1;
+    }
+    if (ShardInput[Shard.Index]>=0) {
+      errs() << "error: shard " << Shard.Index << " given by both "
+             << InputIndices[ShardInput[Shard.Index]] << " and "
+             << InputIndices[i] << "\n";
+      return 1;
+    }
+    ShardInput[Shard.Index] = i;
+  }
+  for (unsigned S = 0; S<Count; S++) {
+    if (ShardInput[S]<0) {
+      errs() << "error: missing shard " << S << " of " << Count << "\n";
+      Failed = true;
+    }
+  }
+  if (Failed)
+    return 1;
+
+  HeatIndex Merged;
+  for (unsigned i = 0; i<Indices.size(); i++) {
+    if (Indices[i].MaxFreq!=Indices[0].MaxFreq)
+      errs() << "warning: " << InputIndices[i]
+             << ": shards were scaled with different maximum frequencies\n";
+    Merged.MaxFreq = std::max(Merged.MaxFreq,Indices[i].MaxFreq);
+    Merged.NumSkipped += Indices[i].NumSkipped;
+    Merged.Entries.insert(Merged.Entries.end(), Indices[i].Entries.begin(),
+                          Indices[i].Entries.end());
+  }
+  Merged.sort();
+  if (Merged.NumSkipped)
+    errs() << "warning: the time budget of the shards ran out before "
+           << Merged.NumSkipped << " functions were written\n";
+
+  SmallString<256> IndexPath;
+  if (!OutputDir.empty()) {
+    if (std::error_code EC = sys::fs::create_directories(OutputDir)) {
+      errs() << "error: cannot create '" << OutputDir << "': " << EC.message()
+             << "\n";
+      return 1;
+    }
+    for (unsigned i = 0; i<Indices.size(); i++) {
+      StringRef InputDir = sys::path::parent_path(InputIndices[i]);
+      for (const HeatIndexEntry &Entry : Indices[i].Entries)
+        Failed |= !copyEntryOutputs(InputDir, Entry.Filename);
+    }
+    IndexPath = OutputDir;
+  }
+  sys::path::append(IndexPath, OutputIndex);
+
+  if (!Merged.write(IndexPath)) {
+    errs() << "error: cannot write '" << IndexPath << "'\n";
+    return 1;
+  }
+  return Failed?1:0;
+}
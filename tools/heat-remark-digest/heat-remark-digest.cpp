@@ -0,0 +1,108 @@
+//===-- heat-remark-digest.cpp - Hot missed remark digest -------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This tool reads the YAML remark files of a build (-pass-remarks-output)
+// and the heat summaries of its modules (-heat-summary), and lists the
+// missed optimizations in hot code, from the hottest one. The remark files
+// are streamed, and only the hottest remarks are kept in memory.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeatRemarkDigest.h"
+#include "HeatSummary.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static cl::list<std::string>
+RemarkFiles(cl::Positional, cl::OneOrMore, cl::desc("<remark files>"));
+
+static cl::list<std::string>
+SummaryFiles("summary", cl::OneOrMore, cl::value_desc("filename"),
+             cl::desc("Heat summary of a module of the build"));
+
+static cl::opt<double>
+MinHeat("min-heat", cl::init(0.1),
+        cl::desc("Minimum heat, in [0,1], of the listed remarks"));
+
+static cl::opt<unsigned>
+Top("top", cl::init(1000),
+    cl::desc("Number of hottest remarks listed"));
+
+static cl::opt<std::string>
+OutputFile("o", cl::init("-"), cl::value_desc("filename"),
+           cl::desc("Output file of the digest"));
+
+static cl::opt<std::string>
+YAMLOutputFile("yaml-output", cl::init(""), cl::value_desc("filename"),
+               cl::desc("Also write the listed remarks as a YAML remark "
+                        "file"));
+
+int main(int argc, char **argv) {
+  sys::PrintStackTraceOnErrorSignal(argv[0]);
+  PrettyStackTraceProgram X(argc, argv);
+  llvm_shutdown_obj Y;
+
+  cl::ParseCommandLineOptions(argc, argv, "hot missed remark digest\n");
+
+  std::vector<HeatSummary> Summaries(SummaryFiles.size());
+  for (unsigned i = 0; i<SummaryFiles.size(); i++) {
+    std::string Error;
+    if (!HeatSummary::read(SummaryFiles[i], Summaries[i], Error)) {
+      errs() << "error: " << SummaryFiles[i] << ": " << Error << "\n";
+      return 1;
+    }
+  }
+
+  HeatRemarkDigest Digest(Summaries, MinHeat, Top);
+  for (const std::string &File : RemarkFiles) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> Buffer =
+        MemoryBuffer::getFileOrSTDIN(File, -1,
+                                     /*RequiresNullTerminator=*/false);
+    if (!Buffer) {
+      errs() << "error: " << File << ": " << Buffer.getError().message()
+             << "\n";
+      return 1;
+    }
+    HeatRemarkReader Reader(**Buffer);
+    HeatRemark R;
+    while (Reader.next(R))
+      Digest.add(R);
+  }
+  Digest.printStats(errs());
+
+  std::error_code EC;
+  raw_fd_ostream Output(OutputFile, EC, sys::fs::F_Text);
+  if (EC) {
+    errs() << "error: " << OutputFile << ": " << EC.message() << "\n";
+    return 1;
+  }
+  Digest.print(Output);
+
+  if (!YAMLOutputFile.empty()) {
+    raw_fd_ostream YAMLOutput(YAMLOutputFile, EC, sys::fs::F_Text);
+    if (EC) {
+      errs() << "error: " << YAMLOutputFile << ": " << EC.message() << "\n";
+      return 1;
+    }
+    Digest.writeYAML(YAMLOutput);
+  }
+  return 0;
+}
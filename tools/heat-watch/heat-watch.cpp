@@ -0,0 +1,373 @@
+//===-- heat-watch.cpp - Rebuild heat CFGs on input changes -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This tool writes the heat CFGs of bitcode files and keeps them up to date
+// while the bitcode files or the profile are rebuilt. The state of every
+// function is kept between updates, and only the functions whose IR or
+// profile changed are recomputed and written again, unless the maximum
+// frequency of the module changed and the heat of all of them with it.
+// Functions are compared by the input key of the output store, a structural
+// hash that editing the other functions of the module does not change.
+//
+// Changes are detected with inotify on Linux and by polling elsewhere.
+//
+//===----------------------------------------------------------------------===//
+
+#include "HeatBFIProvider.h"
+#include "HeatCFGWriter.h"
+#include "HeatMemoryBudget.h"
+#include "HeatModuleLoader.h"
+#include "HeatOutputStore.h"
+#include "HeatProfile.h"
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace llvm;
+
+static cl::list<std::string>
+InputFiles(cl::Positional, cl::OneOrMore, cl::desc("<bitcode files>"));
+
+static cl::opt<std::string>
+ProfileFile("profile", cl::init(""), cl::value_desc("filename"),
+            cl::desc("Annotate the modules with this instrumentation profile"));
+
+static cl::opt<bool>
+CFGOnly("cfg-only", cl::init(false),
+        cl::desc("Print only the block names, as -dot-heat-cfg-only"));
+
+static cl::opt<bool>
+PerFunction("heat-cfg-per-function", cl::init(false),
+            cl::desc("Heat CFG per function"));
+
+static cl::opt<unsigned>
+PageSize("heat-cfg-page-size", cl::init(0), cl::value_desc("blocks"),
+         cl::desc("Split the CFGs with more blocks into pages (0 to disable)"));
+
+static cl::opt<unsigned, true>
+MemoryBudget("heat-memory-budget", cl::value_desc("MB"),
+             cl::location(HeatMemoryBudget::instance().LimitMB),
+             cl::desc("Keep the analyses and labels within this many MB "
+                      "(0 for no limit)"));
+
+static cl::opt<unsigned>
+Delay("delay", cl::init(200), cl::value_desc("ms"),
+      cl::desc("Wait for the inputs to be quiet this long before updating"));
+
+static cl::opt<bool>
+Once("once", cl::init(false),
+     cl::desc("Write the heat CFGs once and exit"));
+
+namespace {
+
+/// State of a function after the last update of its module.
+struct WatchedFunction {
+  std::string InputKey;
+  uint64_t MaxFreq = 0;
+  std::string Output;
+  bool Present = false;
+};
+
+struct WatchedModule {
+  std::string Path;
+  /// Each module has its own context, so that reloading it frees everything
+  /// the previous version created.
+  std::unique_ptr<LLVMContext> Context;
+  std::unique_ptr<Module> M;
+  StringMap<WatchedFunction> Functions;
+  uint64_t MaxFreq = 0;
+};
+
+/// Last modification time and size of a watched file.
+struct FileStamp {
+  sys::TimePoint<> Time;
+  uint64_t Size = 0;
+  bool Exists = false;
+
+  bool operator==(const FileStamp &S) const {
+    return Exists==S.Exists && Time==S.Time && Size==S.Size;
+  }
+};
+
+/// Waits for changes of a set of files. The directories of the files are
+/// watched rather than the files themselves, as build tools usually replace
+/// their outputs by renaming new files over them. Events only wake up the
+/// watcher, the changed files are then found by comparing their stamps.
+class FileWatcher {
+public:
+  explicit FileWatcher(ArrayRef<std::string> Files);
+  ~FileWatcher();
+
+  /// Blocks until some of the files change, and returns their indices.
+  std::vector<unsigned> wait();
+
+private:
+  static FileStamp getStamp(StringRef Path);
+  bool waitForEvent(int TimeoutMs);
+
+  std::vector<std::string> Files;
+  std::vector<FileStamp> Stamps;
+  int FD = -1;
+};
+
+}
+
+FileWatcher::FileWatcher(ArrayRef<std::string> Files)
+    : Files(Files.begin(), Files.end()) {
+  for (const std::string &File : Files)
+    Stamps.push_back(getStamp(File));
+#ifdef __linux__
+  FD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (FD<0)
+    return;
+  StringSet<> Dirs;
+  for (const std::string &File : Files) {
+    StringRef Dir = sys::path::parent_path(File);
+    Dirs.insert(Dir.empty()?".":Dir);
+  }
+  for (auto &Dir : Dirs) {
+    std::string Path = Dir.getKey().str();
+    if (inotify_add_watch(FD, Path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO |
+                                            IN_CREATE | IN_ATTRIB)<0)
+      errs() << "warning: cannot watch '" << Path << "', polling it\n";
+  }
+#endif
+}
+
+FileWatcher::~FileWatcher(){
+#ifdef __linux__
+  if (FD>=0)
+    ::close(FD);
+#endif
+}
+
+FileStamp FileWatcher::getStamp(StringRef Path){
+  FileStamp Stamp;
+  sys::fs::file_status Status;
+  if (sys::fs::status(Path, Status) || !sys::fs::exists(Status))
+    return Stamp;
+  Stamp.Time = Status.getLastModificationTime();
+  Stamp.Size = Status.getSize();
+  Stamp.Exists = true;
+  return Stamp;
+}
+
+/// Returns true if an event arrived within \p TimeoutMs, or after it when
+/// there is no inotify. Pending events are consumed.
+bool FileWatcher::waitForEvent(int TimeoutMs){
+#ifdef __linux__
+  if (FD>=0) {
+    struct pollfd PFD = {FD, POLLIN, 0};
+    if (poll(&PFD, 1, TimeoutMs)<=0)
+      return false;
+    char Buf[4096];
+    while (read(FD, Buf, sizeof(Buf))>0)
+      ;
+    return true;
+  }
+#endif
+  std::this_thread::sleep_for(std::chrono::milliseconds(TimeoutMs));
+  return true;
+}
+
+std::vector<unsigned> FileWatcher::wait(){
+  std::vector<unsigned> Changed;
+  while (Changed.empty()) {
+    // Also poll once per second, in case some directory could not be
+    // watched.
+    if (waitForEvent(1000) && FD>=0) {
+      // Let the writers finish before looking at the files.
+      while (waitForEvent(Delay))
+        ;
+    }
+    for (unsigned i = 0; i<Files.size(); i++) {
+      FileStamp Stamp = getStamp(Files[i]);
+      // A file being replaced may be missing for a moment.
+      if (!Stamp.Exists || Stamp==Stamps[i])
+        continue;
+      Stamps[i] = Stamp;
+      Changed.push_back(i);
+    }
+  }
+  return Changed;
+}
+
+static HeatCFGOptions getHeatCFGOptions(){
+  HeatCFGOptions Opts;
+  Opts.PerFunction = PerFunction;
+  Opts.Simple = CFGOnly;
+  Opts.PageSize = PageSize;
+  return Opts;
+}
+
+/// Removes the file of a function and, for paginated CFGs, its pages.
+static void removeOutput(StringRef Filename){
+  sys::fs::remove(Filename);
+  if (!Filename.endswith(".index.dot"))
+    return;
+  StringRef Prefix = Filename.drop_back(strlen(".index.dot"));
+  for (unsigned P = 0; ; P++) {
+    std::string Page = (Prefix + ".page" + Twine(P) + ".dot").str();
+    if (sys::fs::remove(Page, /*IgnoreNonExisting=*/false))
+      return;
+  }
+}
+
+/// Reloads a module and rewrites the heat CFGs of the functions that changed
+/// since its last update.
+static void updateModule(WatchedModule &WM){
+  WM.M.reset();
+  WM.Context.reset(new LLVMContext());
+  std::string Error;
+  WM.M = loadHeatModule(WM.Path, ProfileFile, *WM.Context, Error);
+  if (!WM.M) {
+    errs() << "error: " << Error;
+    return;
+  }
+  if (!Error.empty())
+    errs() << "warning: " << WM.Path << ": " << Error;
+
+  StringSet<> Changed;
+  unsigned NumDefined = 0;
+  for (Function &F : *WM.M) {
+    if (F.isDeclaration())
+      continue;
+    NumDefined++;
+    std::string Key = HeatOutputStore::getFunctionInputKey(F);
+    WatchedFunction &WF = WM.Functions[F.getName()];
+    WF.Present = true;
+    if (WF.InputKey!=Key) {
+      WF.InputKey = Key;
+      Changed.insert(F.getName());
+    }
+  }
+
+  unsigned NumRemoved = 0;
+  for (auto It = WM.Functions.begin(); It!=WM.Functions.end(); ) {
+    auto Cur = It++;
+    if (Cur->second.Present) {
+      Cur->second.Present = false;
+      continue;
+    }
+    if (!Cur->second.Output.empty())
+      removeOutput(Cur->second.Output);
+    WM.Functions.erase(Cur);
+    NumRemoved++;
+  }
+
+  // Only the frequencies of the changed functions are computed, the maximum
+  // frequencies of the others are known from the previous updates. When all
+  // of them changed, e.g. on the first load, the profile is complete anyway.
+  bool AllChanged = Changed.size()==NumDefined;
+  HeatBFIProvider BFIs;
+  HeatProfileOptions ProfOpts;
+  if (!AllChanged)
+    ProfOpts.Filter = [&Changed](const Function &F) {
+      return Changed.count(F.getName())>0;
+    };
+  std::unique_ptr<HeatProfile> HP(new HeatProfile(*WM.M,BFIs,ProfOpts));
+  HeatMemoryBudget &Budget = HeatMemoryBudget::instance();
+  Budget.acquire(HP->getMemorySize());
+  for (unsigned FI = 0; FI<HP->getNumFunctions(); FI++)
+    WM.Functions[HP->getFunction(FI)->getName()].MaxFreq =
+        HP->getFunctionMaxFreq(FI);
+
+  uint64_t MaxFreq = 0;
+  for (auto &WF : WM.Functions)
+    MaxFreq = std::max(MaxFreq,WF.second.MaxFreq);
+  if (!PerFunction && MaxFreq!=WM.MaxFreq && !AllChanged) {
+    // The heat of every function is relative to the maximum frequency, so
+    // all of them must be written again. BFIs already computed are reused.
+    Budget.release(HP->getMemorySize());
+    HP.reset(new HeatProfile(*WM.M,BFIs));
+    Budget.acquire(HP->getMemorySize());
+  }
+  WM.MaxFreq = MaxFreq;
+
+  HeatCFGOptions Opts = getHeatCFGOptions();
+  Opts.MaxFreq = MaxFreq;
+  for (unsigned FI = 0; FI<HP->getNumFunctions(); FI++) {
+    const Function &F = *HP->getFunction(FI);
+    WatchedFunction &WF = WM.Functions[F.getName()];
+    std::string Output = getHeatCFGOutputFilename(F,Opts);
+    if (!WF.Output.empty() && WF.Output!=Output)
+      removeOutput(WF.Output);
+    if (writeHeatCFGToDotFile(F,*HP,Opts))
+      WF.Output = Output;
+  }
+  Budget.release(HP->getMemorySize());
+
+  errs() << "Updated " << HP->getNumFunctions() << " of "
+         << WM.Functions.size() << " functions of '" << WM.Path << "'";
+  if (NumRemoved)
+    errs() << ", removed " << NumRemoved;
+  errs() << "\n";
+  if (Budget.hasLimit())
+    Budget.report();
+}
+
+int main(int argc, char **argv) {
+  sys::PrintStackTraceOnErrorSignal(argv[0]);
+  PrettyStackTraceProgram X(argc, argv);
+  llvm_shutdown_obj Y;
+
+  cl::ParseCommandLineOptions(argc, argv, "heat CFG watcher\n");
+
+  std::vector<WatchedModule> Modules(InputFiles.size());
+  std::vector<std::string> Files;
+  for (unsigned i = 0; i<InputFiles.size(); i++) {
+    Modules[i].Path = InputFiles[i];
+    Files.push_back(InputFiles[i]);
+  }
+  // The profile is the last watched file, and a change of it updates all
+  // the modules.
+  if (!ProfileFile.empty())
+    Files.push_back(ProfileFile);
+
+  FileWatcher Watcher(Files);
+  for (WatchedModule &WM : Modules)
+    updateModule(WM);
+  if (Once)
+    return 0;
+
+  errs() << "Watching " << Files.size() << " files...\n";
+  while (true) {
+    std::vector<unsigned> Changed = Watcher.wait();
+    bool ProfileChanged = !ProfileFile.empty() &&
+                          Changed.back()==Files.size()-1;
+    for (unsigned i = 0; i<Modules.size(); i++)
+      if (ProfileChanged ||
+          std::find(Changed.begin(), Changed.end(), i)!=Changed.end())
+        updateModule(Modules[i]);
+  }
+}